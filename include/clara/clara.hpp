@@ -3,21 +3,44 @@
 
 #pragma once
 
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <atomic>
+#include <bit>
+#include <charconv>
+#include <cstdio>
 #include <cstring>
 #include <memory>
+#include <memory_resource>
+#include <mutex>
+#include <optional>
+#include <ranges>
 #include <cstdint>
 #include <expected>
 #include <functional>
 #include <iostream>
+#include <limits>
 #include <unordered_map>
 #include <unordered_set>
+#include <variant>
 
 #include <sstream>
 #include <string>
 #include <string_view>
 #include <span>
-
-#define D_PRINT(x) std::cout << x << "\n";
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <typeinfo>
+#include <utility>
+#include <vector>
+
+#if defined(CLARA_DEBUG)
+  #define D_PRINT(x) std::cout << x << "\n";
+#else
+  #define D_PRINT(x)
+#endif
 
 #if defined(__linux__)
   #if defined(__ANDROID__) 
@@ -50,6 +73,22 @@
   #pragma error unknown platform utf-8 will be assumed
 #endif //defined(__linux__)
 
+// x86 simd kernels are compiled with target attributes and picked at runtime (cpuid)
+// so the rest of the code doesn't need any -m flags
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+  #define CLARA_X86_SIMD
+  #include <immintrin.h>
+#endif
+
+// response files are mapped where there's mmap and read into memory elsewhere
+#if __has_include(<sys/mman.h>)
+  #define CLARA_MMAP
+  #include <fcntl.h>
+  #include <sys/mman.h>
+  #include <sys/stat.h>
+  #include <unistd.h>
+#endif
+
 #if not defined(CLARA_WINDOWS)
 
   #define CLARA_UTF8
@@ -99,7 +138,7 @@ namespace utf8 {
         constexpr uint8_t CONTINUATION_SIG = 0x80;
 
         // Get the expected byte count for a UTF-8 sequence based on the first byte
-        inline size_t get_sequence_length(uint8_t first_byte) {
+        constexpr size_t get_sequence_length(uint8_t first_byte) {
             if ((first_byte & ASCII_MASK) == 0) return 1;
             if ((first_byte & TWO_BYTE_MASK) == TWO_BYTE_SIG) return 2;
             if ((first_byte & THREE_BYTE_MASK) == THREE_BYTE_SIG) return 3;
@@ -108,7 +147,7 @@ namespace utf8 {
         }
 
         // Validate continuation bytes in a UTF-8 sequence
-        inline bool validate_continuation(std::string_view input, size_t pos, size_t count) {
+        constexpr bool validate_continuation(std::string_view input, size_t pos, size_t count) {
             for (size_t i = 1; i < count; ++i) {
                 if (pos + i >= input.size() || 
                     (static_cast<uint8_t>(input[pos + i]) & CONTINUATION_MASK) != CONTINUATION_SIG) {
@@ -119,19 +158,235 @@ namespace utf8 {
         }
     }
 
-    // Check if the entire string is valid UTF-8
-    inline bool is_valid_utf8(std::string_view input) {
-        size_t pos = 0;
-        while (pos < input.size()) {
-            uint8_t first_byte = static_cast<uint8_t>(input[pos]);
-            size_t bytes = detail::get_sequence_length(first_byte);
-            if (bytes == 0 || pos + bytes > input.size() || 
-                !detail::validate_continuation(input, pos, bytes)) {
-                return false;
+    namespace detail {
+        // strict (no overlongs, no surrogates, nothing past U+10FFFF), ascii is skipped 8 bytes at a time
+        inline bool is_valid_utf8_scalar(std::string_view input) {
+            const auto* s = reinterpret_cast<const uint8_t*>(input.data());
+            const size_t size = input.size();
+            size_t pos = 0;
+            while (pos < size) {
+                if (pos + 8 <= size) {
+                    uint64_t word;
+                    std::memcpy(&word, s + pos, 8);
+                    if ((word & 0x8080808080808080ull) == 0) {
+                        pos += 8;
+                        continue;
+                    }
+                }
+
+                const uint8_t b = s[pos];
+                if (b < 0x80) {
+                    pos++;
+                    continue;
+                }
+
+                size_t bytes = 0;
+                uint8_t lo = 0x80, hi = 0xBF; // the range of the second byte
+                if (b >= 0xC2 && b <= 0xDF) bytes = 2;
+                else if (b >= 0xE0 && b <= 0xEF) {
+                    bytes = 3;
+                    if (b == 0xE0) lo = 0xA0;      // overlong
+                    else if (b == 0xED) hi = 0x9F; // surrogates
+                }
+                else if (b >= 0xF0 && b <= 0xF4) {
+                    bytes = 4;
+                    if (b == 0xF0) lo = 0x90;      // overlong
+                    else if (b == 0xF4) hi = 0x8F; // past U+10FFFF
+                }
+                else return false;
+
+                if (pos + bytes > size || s[pos + 1] < lo || s[pos + 1] > hi)
+                    return false;
+                for (size_t i = 2; i < bytes; ++i)
+                    if ((s[pos + i] & CONTINUATION_MASK) != CONTINUATION_SIG)
+                        return false;
+                pos += bytes;
             }
-            pos += bytes;
+            return true;
         }
-        return true;
+
+#if defined(CLARA_X86_SIMD)
+        // the lookup algorithm (Keiser & Lemire, "Validating UTF-8 In Less Than One Instruction Per Byte"):
+        // three 16 entry tables indexed by the nibbles of each byte and of the byte before it
+        // flag every invalid 2 byte pattern, what's left (3rd/4th bytes) is checked with saturating subtractions
+        namespace simd {
+            constexpr uint8_t TOO_SHORT = 1 << 0;      // lead followed by a lead/ascii
+            constexpr uint8_t TOO_LONG = 1 << 1;       // ascii followed by a continuation
+            constexpr uint8_t OVERLONG_3 = 1 << 2;
+            constexpr uint8_t TOO_LARGE = 1 << 3;
+            constexpr uint8_t SURROGATE = 1 << 4;
+            constexpr uint8_t OVERLONG_2 = 1 << 5;
+            constexpr uint8_t TOO_LARGE_1000 = 1 << 6;
+            constexpr uint8_t OVERLONG_4 = 1 << 6;
+            constexpr uint8_t TWO_CONTS = 1 << 7;
+            constexpr uint8_t CARRY = TOO_SHORT | TOO_LONG | TWO_CONTS;
+
+            // indexed by the high nibble of the previous byte
+            alignas(16) constexpr uint8_t byte_1_high[16] = {
+                TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG,
+                TWO_CONTS, TWO_CONTS, TWO_CONTS, TWO_CONTS,
+                TOO_SHORT | OVERLONG_2,
+                TOO_SHORT,
+                TOO_SHORT | OVERLONG_3 | SURROGATE,
+                TOO_SHORT | TOO_LARGE | TOO_LARGE_1000 | OVERLONG_4
+            };
+
+            // indexed by the low nibble of the previous byte
+            alignas(16) constexpr uint8_t byte_1_low[16] = {
+                CARRY | OVERLONG_3 | OVERLONG_2 | OVERLONG_4,
+                CARRY | OVERLONG_2,
+                CARRY,
+                CARRY,
+                CARRY | TOO_LARGE,
+                CARRY | TOO_LARGE | TOO_LARGE_1000,
+                CARRY | TOO_LARGE | TOO_LARGE_1000,
+                CARRY | TOO_LARGE | TOO_LARGE_1000,
+                CARRY | TOO_LARGE | TOO_LARGE_1000,
+                CARRY | TOO_LARGE | TOO_LARGE_1000,
+                CARRY | TOO_LARGE | TOO_LARGE_1000,
+                CARRY | TOO_LARGE | TOO_LARGE_1000,
+                CARRY | TOO_LARGE | TOO_LARGE_1000,
+                CARRY | TOO_LARGE | TOO_LARGE_1000 | SURROGATE,
+                CARRY | TOO_LARGE | TOO_LARGE_1000,
+                CARRY | TOO_LARGE | TOO_LARGE_1000
+            };
+
+            // indexed by the high nibble of the current byte
+            alignas(16) constexpr uint8_t byte_2_high[16] = {
+                TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT,
+                TOO_LONG | OVERLONG_2 | TWO_CONTS | OVERLONG_3 | TOO_LARGE_1000 | OVERLONG_4,
+                TOO_LONG | OVERLONG_2 | TWO_CONTS | OVERLONG_3 | TOO_LARGE,
+                TOO_LONG | OVERLONG_2 | TWO_CONTS | SURROGATE | TOO_LARGE,
+                TOO_LONG | OVERLONG_2 | TWO_CONTS | SURROGATE | TOO_LARGE,
+                TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT
+            };
+
+            // a block ending with any of these (in its last 3 bytes) continues in the next one
+            alignas(32) constexpr uint8_t incomplete_max[32] = {
+                255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+                255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 0xF0 - 1, 0xE0 - 1, 0xC0 - 1
+            };
+        }
+
+        struct sse42_state {
+            __m128i error, prev_input, prev_incomplete;
+        };
+
+        // checks one block (lambdas don't get the target attribute so these are functions)
+        __attribute__((target("sse4.2")))
+        inline void check_block_sse42(sse42_state& st, __m128i in) {
+            if (_mm_movemask_epi8(in) == 0) {
+                // all ascii, only a sequence cut at the end of the previous block can be wrong
+                st.error = _mm_or_si128(st.error, st.prev_incomplete);
+            } else {
+                const __m128i nibble = _mm_set1_epi8(0x0F);
+                const __m128i t1h = _mm_load_si128(reinterpret_cast<const __m128i*>(simd::byte_1_high));
+                const __m128i t1l = _mm_load_si128(reinterpret_cast<const __m128i*>(simd::byte_1_low));
+                const __m128i t2h = _mm_load_si128(reinterpret_cast<const __m128i*>(simd::byte_2_high));
+
+                const __m128i prev1 = _mm_alignr_epi8(in, st.prev_input, 15);
+                const __m128i b1h = _mm_shuffle_epi8(t1h, _mm_and_si128(_mm_srli_epi16(prev1, 4), nibble));
+                const __m128i b1l = _mm_shuffle_epi8(t1l, _mm_and_si128(prev1, nibble));
+                const __m128i b2h = _mm_shuffle_epi8(t2h, _mm_and_si128(_mm_srli_epi16(in, 4), nibble));
+                const __m128i special = _mm_and_si128(_mm_and_si128(b1h, b1l), b2h);
+
+                const __m128i prev2 = _mm_alignr_epi8(in, st.prev_input, 14);
+                const __m128i prev3 = _mm_alignr_epi8(in, st.prev_input, 13);
+                const __m128i third = _mm_subs_epu8(prev2, _mm_set1_epi8(static_cast<char>(0xE0 - 0x80)));
+                const __m128i fourth = _mm_subs_epu8(prev3, _mm_set1_epi8(static_cast<char>(0xF0 - 0x80)));
+                const __m128i must23 = _mm_and_si128(_mm_or_si128(third, fourth), _mm_set1_epi8(static_cast<char>(0x80)));
+                st.error = _mm_or_si128(st.error, _mm_xor_si128(must23, special));
+                st.prev_incomplete = _mm_subs_epu8(in, _mm_loadu_si128(reinterpret_cast<const __m128i*>(simd::incomplete_max + 16)));
+            }
+            st.prev_input = in;
+        }
+
+        __attribute__((target("sse4.2")))
+        inline bool is_valid_utf8_sse42(std::string_view input) {
+            sse42_state st{ _mm_setzero_si128(), _mm_setzero_si128(), _mm_setzero_si128() };
+            size_t pos = 0;
+            for (; pos + 16 <= input.size(); pos += 16)
+                check_block_sse42(st, _mm_loadu_si128(reinterpret_cast<const __m128i*>(input.data() + pos)));
+            if (pos < input.size()) {
+                alignas(16) char tail[16] = {};
+                std::memcpy(tail, input.data() + pos, input.size() - pos);
+                check_block_sse42(st, _mm_load_si128(reinterpret_cast<const __m128i*>(tail)));
+            }
+            const __m128i error = _mm_or_si128(st.error, st.prev_incomplete);
+            return _mm_testz_si128(error, error);
+        }
+
+        struct avx2_state {
+            __m256i error, prev_input, prev_incomplete;
+        };
+
+        __attribute__((target("avx2")))
+        inline void check_block_avx2(avx2_state& st, __m256i in) {
+            if (_mm256_movemask_epi8(in) == 0) {
+                st.error = _mm256_or_si256(st.error, st.prev_incomplete);
+            } else {
+                const __m256i nibble = _mm256_set1_epi8(0x0F);
+                const __m256i t1h = _mm256_broadcastsi128_si256(_mm_load_si128(reinterpret_cast<const __m128i*>(simd::byte_1_high)));
+                const __m256i t1l = _mm256_broadcastsi128_si256(_mm_load_si128(reinterpret_cast<const __m128i*>(simd::byte_1_low)));
+                const __m256i t2h = _mm256_broadcastsi128_si256(_mm_load_si128(reinterpret_cast<const __m128i*>(simd::byte_2_high)));
+
+                // the bytes before each byte (alignr works per 128 bit lane so stitch the lanes first)
+                const __m256i shifted = _mm256_permute2x128_si256(st.prev_input, in, 0x21);
+                const __m256i prev1 = _mm256_alignr_epi8(in, shifted, 15);
+                const __m256i b1h = _mm256_shuffle_epi8(t1h, _mm256_and_si256(_mm256_srli_epi16(prev1, 4), nibble));
+                const __m256i b1l = _mm256_shuffle_epi8(t1l, _mm256_and_si256(prev1, nibble));
+                const __m256i b2h = _mm256_shuffle_epi8(t2h, _mm256_and_si256(_mm256_srli_epi16(in, 4), nibble));
+                const __m256i special = _mm256_and_si256(_mm256_and_si256(b1h, b1l), b2h);
+
+                const __m256i prev2 = _mm256_alignr_epi8(in, shifted, 14);
+                const __m256i prev3 = _mm256_alignr_epi8(in, shifted, 13);
+                const __m256i third = _mm256_subs_epu8(prev2, _mm256_set1_epi8(static_cast<char>(0xE0 - 0x80)));
+                const __m256i fourth = _mm256_subs_epu8(prev3, _mm256_set1_epi8(static_cast<char>(0xF0 - 0x80)));
+                const __m256i must23 = _mm256_and_si256(_mm256_or_si256(third, fourth), _mm256_set1_epi8(static_cast<char>(0x80)));
+                st.error = _mm256_or_si256(st.error, _mm256_xor_si256(must23, special));
+                st.prev_incomplete = _mm256_subs_epu8(in, _mm256_load_si256(reinterpret_cast<const __m256i*>(simd::incomplete_max)));
+            }
+            st.prev_input = in;
+        }
+
+        __attribute__((target("avx2")))
+        inline bool is_valid_utf8_avx2(std::string_view input) {
+            avx2_state st{ _mm256_setzero_si256(), _mm256_setzero_si256(), _mm256_setzero_si256() };
+            size_t pos = 0;
+            for (; pos + 32 <= input.size(); pos += 32)
+                check_block_avx2(st, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(input.data() + pos)));
+            if (pos < input.size()) {
+                alignas(32) char tail[32] = {};
+                std::memcpy(tail, input.data() + pos, input.size() - pos);
+                check_block_avx2(st, _mm256_load_si256(reinterpret_cast<const __m256i*>(tail)));
+            }
+            const __m256i error = _mm256_or_si256(st.error, st.prev_incomplete);
+            return _mm256_testz_si256(error, error);
+        }
+#endif // defined(CLARA_X86_SIMD)
+
+        using validate_fn = bool (*)(std::string_view);
+
+        // the best kernel this cpu has, picked once
+        inline validate_fn best_validator() {
+            static const validate_fn fn = [] () -> validate_fn {
+#if defined(CLARA_X86_SIMD)
+                __builtin_cpu_init();
+                if (__builtin_cpu_supports("avx2")) return is_valid_utf8_avx2;
+                if (__builtin_cpu_supports("sse4.2")) return is_valid_utf8_sse42;
+#endif
+                return is_valid_utf8_scalar;
+            }();
+            return fn;
+        }
+    }
+
+    // Check if the entire string is valid UTF-8 (strict)
+    // short strings (e.g. most argv words) aren't worth the simd setup
+    inline bool is_valid_utf8(std::string_view input) {
+        if (input.size() < 64)
+            return detail::is_valid_utf8_scalar(input);
+        return detail::best_validator()(input);
     }
 
     // Advance position by one UTF-8 character
@@ -330,7 +585,7 @@ namespace utf8 {
     }
 
     // Check if string is a single UTF-8 character
-    inline bool is_single_char(std::string_view str) {
+    constexpr bool is_single_char(std::string_view str) {
         if (str.empty()) return false;
         uint8_t first_byte = static_cast<uint8_t>(str[0]);
         size_t bytes = detail::get_sequence_length(first_byte);
@@ -352,1731 +607,5805 @@ namespace utf8 {
       delimiter, double_delimiter
     };
 
+    // tokens don't own their literal, it's a view into the lexer input
+    // (or into the lexer's own storage for the few tokens that had to be unescaped)
+    // so copying a token is just copying a type and a view
     struct token 
     {
       token() = default;
-      token(token_type t, const char ch) //for ascii and tokens with single ascii char
-        : type(t), literal(std::string(1, ch))
-      {
-      }
-
       token(token_type t, const std::string_view str) //utf-8 and tokens with muliple chars
         : type(t), literal(str)
       {
       }
 
-      token_type type;
-      std::string literal;
+      token_type type{ token_type::eof };
+      std::string_view literal;
     };
 
-    constexpr std::string_view token_type_to_string(const token_type tt)
+    // transparent hash so the string keyed maps can be searched with a string_view 
+    // (no std::string construction for each lookup)
+    struct string_hash
     {
-      using namespace std::string_view_literals;
-      switch(tt)
+      using is_transparent = void;
+      size_t operator()(std::string_view str) const noexcept
       {
-        //case token_type::illegal:          return "illegal"sv;
-        case token_type::eof:              return "eof"sv;
-        case token_type::identifire:       return "identifire"sv;
-        //case token_type::number:           return "number"sv;
-        case token_type::string:           return "string"sv;
-        case token_type::space:            return "space"sv;
-        case token_type::assign:           return "assign"sv;
-        case token_type::delimiter:        return "delimiter"sv;
-        case token_type::double_delimiter: return "double_delimiter"sv;
-        //default:                           return "unknown"sv;
+        return std::hash<std::string_view>{}(str);
       }
+    };
+
+    template <typename V>
+    using string_map = std::unordered_map<std::string, V, string_hash, std::equal_to<>>;
+    using string_set = std::unordered_set<std::string, string_hash, std::equal_to<>>;
+
+    template <typename V>
+    using pmr_string_map = std::pmr::unordered_map<std::pmr::string, V, string_hash, std::equal_to<>>;
+
+    // sessions are aligned to it so sessions of different threads never share a cache line
+    inline constexpr size_t cache_line_size = 64;
+
+    // value i of a value list: the values are in raw separated by one space, ends has where each one ends
+    // (empty if raw is a single value)
+    inline std::string_view nth_value(std::string_view raw, std::span<const uint32_t> ends, size_t i)
+    {
+      if(ends.empty())
+        return raw;
+      const size_t begin = i == 0 ? 0 : ends[i - 1] + 1;
+      return raw.substr(begin, ends[i] - begin);
     }
 
-    class lexer
+    // upstream of the session arenas, it counts the bytes the arena had to ask for
+    // after it ran out of its initial buffer (so the next buffer can be big enough)
+    class counting_resource : public std::pmr::memory_resource
     {
     public:
-      using input_type = std::string_view;
-      using delimiter_set = std::unordered_set<std::string_view>;
-    public:
-      lexer() = default;
-      lexer(const input_type input, const delimiter_set& ds = make_default_delimiters_set())
-        : m_input(input), m_delimiters(ds)
+      size_t allocated() const { return m_allocated; }
+      void reset_count() { m_allocated = 0; }
+    private:
+      void* do_allocate(size_t bytes, size_t alignment) override
       {
-        m_current = read_char();
+        m_allocated += bytes;
+        return std::pmr::new_delete_resource()->allocate(bytes, alignment);
       }
 
-      token advance()
+      void do_deallocate(void* p, size_t bytes, size_t alignment) override
       {
-        using namespace std::string_view_literals;
-        
-        consume_whitespace();
-        token tok;
-
-        switch(m_current)
-        {
-          case U'=':
-          {
-            //skip it
-            //read_char();
-            //return advance();
-            tok = { token_type::assign, "="sv };
-            break;
-          }
-          case U'\'':
-          {
-            tok.type = token_type::string;
-            tok.literal = read_string(U'\'');
-            break;
-          }
-          case U'"':
-          {  
-            tok.type = token_type::string;
-            tok.literal = read_string(U'"');
-            break;
-          }
-          case U' ':
-          case U'\t':
-          case U'\n':
-          {
-            tok.type = token_type::space;
-            tok.literal = " ";
-            break;
-          }
-          case 0:
-          {  
-            tok = { token_type::eof, ""sv };
-            break;
-          }
-          default:
-          {
-            //always return from here on, we don't need to read_char at the end
-            if(is_delimiter(m_current))
-            {
-              auto pc = peek_char();
-              if(is_delimiter(pc))
-              {
-                tok.type = token_type::double_delimiter;
-                tok.literal = utf8::encode(m_current) + utf8::encode(pc);
-                read_char(); //skip the next delimiter (it's part of double_delimiter)
-              }
-              else 
-              {
-                tok.type = token_type::delimiter;
-                tok.literal = utf8::encode(m_current);
-              }
-              m_current = read_char();
-              return tok;
-            }
-            else if(utf8::is_valid_utf8(utf8::encode(m_current)))//(utf8::is_identifier(utf8::encode(m_current)))
-            {
-              tok.literal = read_identifire();
-              tok.type = token_type::identifire;
-              return tok;
-            }
-            //if(utf8::is_number(utf8::encode(m_current)))
-            //{
-            //  //TODO: floats/ints/uints //or just number as double idk
-            //  tok.literal = read_number();
-            //  tok.type = token_type::number;
-            //  return tok;
-            //}
-            //{
-            //  //convert to utf-8 for the literal 
-            //  std::string literal;
-            //  if(m_current <= 0x7f)
-            //    literal = std::string(1, static_cast<char>(m_current));
-            //  else //TODO: FIXME: proper utf-8 encoding
-            //    literal = utf8::encode(m_current);
-            //  
-            //  tok = { token_type::illegal, literal };
-            //}
-            break;
-          }
-        }
-        m_current = read_char();
-        return tok;
+        std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
       }
-    private:
-      code_point read_char()
-      {
-        if(m_read_position >= m_input.size())
-          return 0; //eof
 
-        auto pos = m_read_position;
-        code_point ch = utf8::decode(m_input, pos);
-        m_position = m_read_position;
-        m_read_position = pos;
-        return ch;
+      bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override
+      {
+        return this == &other;
       }
+    private:
+      size_t m_allocated{ 0 };
+    };
 
-      code_point peek_char() const
+    // [0, count) split into one range per worker, a worker takes chunks from the front of its own range
+    // and once it's empty it steals the back half of the biggest range left, a range is one atomic
+    // (begin in the high half and end in the low half) so the owner and the thieves just CAS it
+    class work_ranges
+    {
+    public:
+      // count must fit in 32 bits
+      work_ranges(size_t count, size_t workers, size_t chunk)
+        : m_ranges(std::make_unique<range[]>(workers)), m_workers(workers), m_chunk(std::max<size_t>(1, chunk))
       {
-        if(m_read_position >= m_input.size())
-          return 0;
-        auto pos = m_read_position;
-        return utf8::decode(m_input, pos);
+        for(size_t w = 0; w < workers; w++)
+          m_ranges[w].bits.store(pack(count * w / workers, count * (w + 1) / workers), std::memory_order_relaxed);
       }
-     
-      //all read_xxx functions return string_view because it's just reading from m_input and there is no need for another copy (other than in token)
-      std::string_view read_identifire()
+
+      // the next chunk [begin, end) of worker w, false once there is nothing left anywhere
+      bool next(size_t w, size_t& begin, size_t& end)
       {
-        bool f{false};
-        size_t pos = m_position;
-        
-        //allow identifires to have number in them but not the first char like: foo_1 but not like: 1_foo (tricky to lex)
-        while(!std::isspace(m_current & 0xff) && utf8::is_valid_utf8(utf8::encode(m_current)))//utf8::is_letter(m_current) || utf8::is_digit(m_current) || utf8::is_emoji(m_current))
-        //while(utf8::is_valid_utf8(utf8::encode(m_current)))
+        while(!take(w, begin, end))
         {
-          if(m_current == U'=')
-          {
-            f = true;
-            break; //TODO: validate this pls
-          }
-          m_current = read_char();
-        } 
-        const auto& sub = m_input.substr(pos, m_position - pos);
-        return sub;
+          if(!steal(w))
+            return false;
+        }
+        return true;
       }
+    private:
+      struct alignas(cache_line_size) range
+      {
+        std::atomic<uint64_t> bits{ 0 };
+      };
 
-      std::string_view read_number()
+      static uint64_t pack(uint64_t begin, uint64_t end)
       {
-        size_t pos = m_position;
-        //TODO: add support for floats and sceintific notation and hex, oct, etc..
-        while(utf8::is_digit(m_current))
-        {
-          m_current = read_char();
-        }
-        return m_input.substr(pos, m_position - pos);
+        return begin << 32 | end;
       }
 
-      std::string_view read_string(code_point open)
+      bool take(size_t w, size_t& begin, size_t& end)
       {
-        m_current = read_char(); //skip open
-        size_t pos = m_position; //after open 
-        
+        auto& r = m_ranges[w].bits;
+        auto bits = r.load(std::memory_order_acquire);
         while(true)
         {
-          if(m_current == open)
-            break;
-          else if (m_current == U'\0') //same as 0 but to be explicit
-            break; //TODO: lex error unterminated string 
-                   //TODO: don't allow stupidly long strings 
-          m_current = read_char();
+          const auto b = bits >> 32, e = bits & 0xffffffff;
+          if(b >= e)
+            return false;
+
+          const auto n = std::min<uint64_t>(m_chunk, e - b);
+          if(r.compare_exchange_weak(bits, pack(b + n, e), std::memory_order_acq_rel, std::memory_order_acquire))
+          {
+            begin = b;
+            end = b + n;
+            return true;
+          }
         }
-        return m_input.substr(pos, m_position - pos);
       }
 
-      void consume_whitespace()
+      bool steal(size_t w)
       {
-        //only redundent whitespace
-        while(std::isspace(m_current & 0xff) && peek_char() != 0 && std::isspace(peek_char() & 0xff)) 
+        while(true)
         {
-          m_current = read_char();
-        }
-        //while(std::isspace(m_current & 0xff) || m_current == U'\n' || m_current == U'\t')
-        //{
-        //  m_current = read_char();
-        //}
-      }
+          size_t victim = m_workers;
+          uint64_t victim_bits = 0, most = 0;
+          for(size_t v = 0; v < m_workers; v++)
+          {
+            const auto bits = m_ranges[v].bits.load(std::memory_order_acquire);
+            const auto b = bits >> 32, e = bits & 0xffffffff;
+            if(v != w && e > b && e - b > most)
+            {
+              victim = v;
+              victim_bits = bits;
+              most = e - b;
+            }
+          }
 
-      bool is_delimiter(code_point cp)
-      {
-        auto r = m_delimiters.find(utf8::encode(cp)) != m_delimiters.end();
-        return r;
-      }
+          if(victim == m_workers)
+            return false; // everything is taken
 
-      static delimiter_set make_default_delimiters_set()
-      {
-        return delimiter_set{ 
-          CLARA_DELIMITER
-        };
+          const auto b = victim_bits >> 32, e = victim_bits & 0xffffffff;
+          const auto mid = b + (e - b) / 2;
+          if(m_ranges[victim].bits.compare_exchange_strong(victim_bits, pack(b, mid), std::memory_order_acq_rel))
+          {
+            // nobody steals from an empty range so this can't race with a thief
+            m_ranges[w].bits.store(pack(mid, e), std::memory_order_release);
+            return true;
+          }
+          // the victim (or another thief) got there first, look again
+        }
       }
     private:
-      input_type m_input;
-      size_t m_position{ 0 };
-      size_t m_read_position{ 0 };
-      code_point m_current{ 0 };
-      delimiter_set m_delimiters;
+      std::unique_ptr<range[]> m_ranges;
+      size_t m_workers;
+      size_t m_chunk;
     };
 
-  } //namespace detail
-
-  namespace parse 
-  {
-    class option_builder;
-    
-    template <typename T> 
-    std::pair<T, bool> get(const std::string& value)
-    {
-      static_assert(false, "no template specialization found");
-    }
-
-    template <>
-    inline std::pair<std::string, bool> get(const std::string& value)
+    // runs fun(worker, begin, end) over chunks of [0, count) on 'workers' threads 
+    // (the calling thread is worker 0), it returns once everything is done
+    template <typename FUN>
+    void parallel_for(size_t count, size_t workers, size_t chunk, FUN&& fun)
     {
-      return { value, true };
-    }
+      workers = std::max<size_t>(1, std::min(workers, count));
+      work_ranges ranges{ count, workers, chunk };
+      auto work = [&](size_t w) {
+        size_t begin = 0, end = 0;
+        while(ranges.next(w, begin, end))
+          fun(w, begin, end);
+      };
 
-    template <>
-    inline std::pair<int64_t, bool> get(const std::string& value)
-    {
-      int64_t i64 = 0;
-      try {
-        i64 = std::stol(value);
-      } catch(...) {
-        return { 0, false };
-      }
-      return { i64, true };
+      std::vector<std::jthread> threads;
+      threads.reserve(workers - 1);
+      for(size_t w = 1; w < workers; w++)
+        threads.emplace_back(work, w);
+      work(0);
     }
 
-    template <>
-    inline std::pair<uint64_t, bool> get(const std::string& value)
+    // one entry of a command's symbol table, a name can be many things at once
+    // (e.g. '-v' a flag and '--v' an option) so each entry is tagged with all of them
+    struct symbol
     {
-      uint64_t u64 = 0;
-      try {
-        u64 = std::stoul(value);
-      } catch(...) {
-        return { 0, false };
-      }
-      return { u64, false };
-    }
+      enum kind : uint8_t
+      {
+        none = 0, option = 1 << 0, alias = 1 << 1, flag = 1 << 2, subcommand = 1 << 3
+      };
 
-    template <>
-    inline std::pair<double, bool> get(const std::string& name)
-    {
-      double d = 0.0f;
-      try {
-        d = std::stod(name);
-      } catch(...) {
-        return { 0.0f, false };
+      constexpr bool is(kind k) const
+      {
+        return (kinds & k) != 0;
       }
-      return { d, true };
-    }
 
-    class command_builder;
+      std::string_view name;
+      uint8_t kinds{ none };
+      uint32_t option_index{ 0 };     // the option (option)
+      uint32_t alias_index{ 0 };      // the aliased option (alias)
+      uint32_t subcommand_index{ 0 }; // the subcommand in the schema (subcommand)
+      uint32_t flag_index{ 0 };       // the flag (flag)
+      uint32_t child_index{ 0 };      // the subcommand in its parent (subcommand)
+    };
 
-    class option_builder
+    // immutable perfect hash table (hash and displace): the names are hashed once into a bucket,
+    // each bucket has a seed that was searched at build time so that every name of the bucket
+    // lands in a free slot, so a lookup is one hash, one probe and one compare
+    // it's built in a constant expression too, then its slots and seeds can be static arrays that a table views
+    class symbol_table
     {
     public:
-      using default_value_type = std::string;
-      enum class alias_options
-      {
-        off, single_delimiter, double_delimiter, //TODO: (or maybe not) as_name
-        _default = single_delimiter
-      };
-    public:
-      option_builder& requires_value() // e.g. g++ -o a.out
-      {
-        m_requires_value = true;
-        return *this;
-      }
+      constexpr symbol_table() = default;
 
-      option_builder& allow_multiple()
+      // names must be unique
+      constexpr explicit symbol_table(std::span<const symbol> symbols)
       {
-        m_allows_multiple = true;
-        return *this;
-      }
+        if(symbols.empty())
+          return;
 
-      option_builder& set_alias(const std::string& name); //via the parent
+        size_t slots = std::bit_ceil(symbols.size());
+        if(slots - symbols.size() < slots / 8) // keep some room so the seed search stays short
+          slots *= 2;
 
-      option_builder& set_alias_options(alias_options opts)
-      {
-        m_alias_opts = opts;
-        return *this;
+        // a bucket that can't be placed in a reasonable number of seeds gets a bigger table,
+        // and if even that doesn't help (64 bit collision) a new salt for the hash
+        for(uint64_t salt = 0; ; salt++)
+        {
+          for(size_t size = slots; size <= slots * 8; size *= 2)
+            if(build(symbols, size, salt))
+              return;
+        }
       }
-      option_builder() = default;
-    private:
-      option_builder(command_builder* parent, const std::string& name)
-        : m_parent(parent), m_name(name)
+
+      // a table over the slots() and seeds() of one that was built before (e.g. at compile time), 
+      // they must outlive it
+      constexpr symbol_table(std::span<const symbol> slots, std::span<const uint32_t> seeds, uint64_t salt, size_t size)
+        : m_slots(slots), m_seeds(seeds), m_salt(salt), m_size(size)
       {
       }
-    private:
-      bool m_requires_value{ false };
-      bool m_allows_multiple{ false };
-      alias_options m_alias_opts{ alias_options::_default };
-      command_builder* m_parent{ nullptr };
-      std::string m_name;
-    private:
-      friend class parser;
-      friend class command_builder;
-    };
-
 
-    class command_builder 
-    {
-    public:
-      using default_value_type = std::string;
-    public:
-      
-      //new one for the added command
-      command_builder& add_subcommand(const std::string& name) // e.g. git submodule
+      constexpr symbol_table(const symbol_table& other)
+        : m_owned_slots(other.m_owned_slots), m_owned_seeds(other.m_owned_seeds), m_slots(other.m_slots), m_seeds(other.m_seeds),
+          m_salt(other.m_salt), m_size(other.m_size)
       {
-        auto& sub = m_subcommands[name];
-        sub.m_debug_name = name; // debug only
-        return sub;
+        rebase();
       }
 
-      option_builder& add_option(const std::string& name) // e.g. git --version
+      constexpr symbol_table(symbol_table&& other) noexcept
+        : m_owned_slots(std::move(other.m_owned_slots)), m_owned_seeds(std::move(other.m_owned_seeds)), m_slots(other.m_slots), 
+          m_seeds(other.m_seeds), m_salt(other.m_salt), m_size(other.m_size)
       {
-        auto& opt = m_options[name];
-        opt = option_builder{ this, name };
-        return opt;
+        rebase();
+        other.m_slots = {};
+        other.m_seeds = {};
+        other.m_size = 0;
       }
 
-      command_builder& add_flag(const std::string& name) // must be one utf-8 char 
-                                                         // e.g git -v
+      constexpr symbol_table& operator=(symbol_table other) noexcept
       {
-        m_flags.emplace(name);
+        m_owned_slots = std::move(other.m_owned_slots);
+        m_owned_seeds = std::move(other.m_owned_seeds);
+        m_slots = other.m_slots;
+        m_seeds = other.m_seeds;
+        m_salt = other.m_salt;
+        m_size = other.m_size;
+        rebase();
         return *this;
       }
 
-      command_builder& requires_value() // e.g. git submodule add <url> <path> 
-                                        // this could require a value of type string array
+      constexpr const symbol* find(std::string_view name) const
       {
-        m_requires_value = true;
-        return *this;
+        if(m_slots.empty())
+          return nullptr;
+
+        const auto h = hash(name, m_salt);
+        const auto& sym = m_slots[slot(h, m_seeds[bucket(h)])];
+        if(sym.kinds != symbol::none && sym.name == name)
+          return &sym;
+        return nullptr;
       }
 
-      command_builder& allows_multiple()
+      constexpr size_t size() const
       {
-        m_allows_multiple = true;
-        return *this;
+        return m_size;
       }
 
-      command_builder& set_option_alias(const std::string& alias_name, const std::string& option_name) //TODO: clash resulotion config
+      constexpr std::span<const symbol> slots() const
       {
-        m_options_aliases[alias_name] = option_name;
-        return *this;
+        return m_slots;
       }
-    public://private:
-      command_builder() = default;
-    private:
-      std::string m_debug_name;
-      std::unordered_map<std::string, command_builder> m_subcommands;
-      std::unordered_map<std::string, option_builder> m_options;
-      std::unordered_set<std::string> m_flags;
-      std::unordered_map<std::string, std::string> m_options_aliases;// { alias : option } 
-      bool m_requires_value{ false };
-      bool m_allows_multiple{ false };
-    private:
-      friend class parser;
-    };
- 
-    inline option_builder& option_builder::set_alias(const std::string& name)
-    {
-      m_parent->set_option_alias(name, m_name);
-      return *this;
-    }
-
 
-    /*
-    class hashable 
-    {
-    public:
-      hashable() = default;
-      hashable(std::string_view name)
-        : m_name(name)
+      constexpr std::span<const uint32_t> seeds() const
       {
+        return m_seeds;
       }
 
-      const std::string& get_name() const
+      constexpr uint64_t salt() const
       {
-        return m_name;
+        return m_salt;
       }
 
-      bool operator == (const hashable& h)
+      // 8 bytes at a time, finalized so names that differ only in their last chars don't end up in the same bucket
+      static constexpr uint64_t hash(std::string_view str, uint64_t salt = 0)
       {
-        return m_name == h.m_name;
+        uint64_t h = 0x9e3779b97f4a7c15ull ^ salt ^ str.size();
+        size_t pos = 0;
+        for(; pos + 8 <= str.size(); pos += 8)
+          h = std::rotl((h ^ load(str, pos, 8)) * 0xff51afd7ed558ccdull, 29);
+        // the tail is the last 8 bytes (overlapping) unless the whole name is shorter than that
+        h ^= str.size() >= 8 ? load(str, str.size() - 8, 8) : load(str, 0, str.size());
+        return mix(h);
       }
-    protected:
-      std::string m_name;
-    };
-
-    struct hashable_hash
-    {
-      size_t operator()(const hashable& hb)
+    private:
+      // little endian load that the compiler turns into one load (and still works in constexpr)
+      static constexpr uint64_t load(std::string_view str, size_t pos, size_t n)
       {
-        return std::hash<std::string>{}(hb.get_name());
+        uint64_t w = 0;
+        for(size_t i = 0; i < n; i++)
+          w |= static_cast<uint64_t>(static_cast<uint8_t>(str[pos + i])) << (8 * i);
+        return w;
       }
-    };
-    */
 
+      // murmur3 finalizer
+      static constexpr uint64_t mix(uint64_t h)
+      {
+        h ^= h >> 33;
+        h *= 0xff51afd7ed558ccdull;
+        h ^= h >> 33;
+        h *= 0xc4ceb9fe1a85ec53ull;
+        h ^= h >> 33;
+        return h;
+      }
 
-    // for now options that allows multiple values are final by that i mean you can't use any other option after an option that requires a value.
-    // i don't know if this is what it supposed to be or there is another way around but i didn't see any program that do otherwise
-    // the other way around is forcing syntax like: 
-    // multiple(arrays): --opt = [val1, val2, val3] (or) --opt = [val1 val2 val3] with or without an equals sign
-    // maps: --opt = { key1 : value1, key2 : value2 } (or) --opt = { ke1 : value1 key2: value2 } with or without an equal sign
-    // this forces keys on maps to don't have space in them or you can use a string literal to do so or we can remove the none comma version
-    // maybe allow both and if usage is without brackets assume final otherwise don't (best of both worlds) i guess
-    class option //: public hashable
-    {
-    public:
-      enum class state 
+      // an owning table's spans are its own vectors
+      constexpr void rebase()
       {
-        not_convertable, no_value
-      };
-    public:
-      bool has_value() const
+        if(!m_owned_slots.empty())
+        {
+          m_slots = m_owned_slots;
+          m_seeds = m_owned_seeds;
+        }
+      }
+
+      constexpr size_t bucket(uint64_t h) const
       {
-        return !m_value.empty();
+        return (h >> 32) & (m_seeds.size() - 1);
       }
 
-      const std::string& get_raw() const
+      constexpr size_t slot(uint64_t h, uint32_t seed) const
       {
-        return m_value;
+        // the seed has to change every bit of the slot
+        h ^= seed * 0x9e3779b97f4a7c15ull;
+        h *= 0xff51afd7ed558ccdull;
+        return (h ^ (h >> 32)) & (m_slots.size() - 1);
       }
 
-      template <typename T>
-      std::expected<T, state> get() const
+      constexpr bool build(std::span<const symbol> symbols, size_t slots, uint64_t salt)
       {
-        if(!m_value.empty())
+        constexpr uint32_t max_seed = 1 << 16;
+
+        m_salt = salt;
+        m_owned_slots.assign(slots, symbol{});
+        m_owned_seeds.assign(std::bit_ceil(std::max<size_t>(1, symbols.size() / 2)), 0);
+        m_slots = m_owned_slots;
+        m_seeds = m_owned_seeds;
+        m_size = symbols.size();
+
+        std::vector<std::vector<uint32_t>> buckets(m_seeds.size());
+        std::vector<uint64_t> hashes(symbols.size());
+        for(uint32_t i = 0; i < symbols.size(); i++)
         {
-          auto r = get<T>(m_value);
-          if(r.second)
-            return r.first;
-          
-          return std::unexpected(state::not_convertable);
+          hashes[i] = hash(symbols[i].name, salt);
+          buckets[bucket(hashes[i])].push_back(i);
         }
-        return std::unexpected(state::no_value);
-      }
-      
-      //allow both '--opt [opt1, opt2, opt3]' and '--opt opt1 opt2 opt3'
-      template <typename T>
-      std::expected<std::vector<T>, state> get_vector() const
-      {
-        if(m_value.empty())
-          return std::unexpected(state::no_value);
-        
-        std::vector<T> vec;
-        size_t last_d = 0;
-        for(auto i = 0; i < m_value.size(); i++)
+
+        // the biggest buckets first while the table is still empty
+        std::vector<uint32_t> order(buckets.size());
+        for(uint32_t i = 0; i < order.size(); i++)
+          order[i] = i;
+        std::sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) { return buckets[a].size() > buckets[b].size(); });
+
+        std::vector<bool> used(slots, false);
+        std::vector<size_t> placed;
+        for(const auto b : order)
         {
-          if(m_value[i] == ' ')
+          if(buckets[b].empty())
+            break;
+
+          bool ok = false;
+          for(uint32_t seed = 0; seed < max_seed && !ok; seed++)
           {
-            auto r = get<T>(m_value.substr(last_d, i));
-            if(r.second)
+            placed.clear();
+            ok = true;
+            for(const auto i : buckets[b])
             {
-              vec.emplace_back(r.first);
-              last_d = i;
+              const auto s = slot(hashes[i], seed);
+              if(used[s] || std::find(placed.begin(), placed.end(), s) != placed.end())
+              {
+                ok = false;
+                break;
+              }
+              placed.push_back(s);
             }
-            else 
+
+            if(ok)
             {
-              return std::unexpected(state::no_value);
+              m_owned_seeds[b] = seed;
+              for(size_t j = 0; j < placed.size(); j++)
+              {
+                used[placed[j]] = true;
+                m_owned_slots[placed[j]] = symbols[buckets[b][j]];
+              }
             }
           }
-        }
-        
-        if(last_d < m_value.size()) 
-        {
-          auto r = get<T>(m_value.substr(last_d));
-          if (r.second) vec.emplace_back(r.first);
-        }
 
-        return vec;
+          if(!ok)
+            return false;
+        }
+        return true;
       }
-
-      //TODO: maybe requires map, and usage would be: --opt { key1:value1 key1:value1 }
-      //bool operator == (const option& opt) const
-      //{
-      //  return m_name == opt.m_name;
-      //}
-    //private:
-      option() = default;
-
-      //option(std::string_view name, std::string_view val = "")
-      //  : m_name(name), m_value(val)
-      //{
-      //}
-    private:
-      //std::string m_name;
-      std::string m_value;
-    private:
-      friend class parser;
-    };
-
-    
-    // idon't know if flags should allow values or not like: 'g++ -std=c++23'
-    // this don't make sense in our implementation because:
-    // -1: -std would translate to -s -t -d 
-    // -2: flags don't have values either called or not
-    // unless aliases would override the default parse behavior
-    // only then '-std=c++23' would translate to something like: ' --standard_version=c++23 ' 
-    // this is what i'll implement but i have no idea how to do so efficiently
-    class flag //: public hashable
-    {
-    public:
-      //bool operator == (const flag& f) const
-      //{
-      //  return m_name == f.m_name;
-      //}
-    private:
-      //std::string m_name;
-    public://private:
-      flag() = default;
-      //explicit flag(std::string_view name, bool val = false)
-      //  : m_name(name), m_value(val)
-      //{
-      //}
     private:
-      friend class parser;
+      std::vector<symbol> m_owned_slots; // empty if the table views static ones
+      std::vector<uint32_t> m_owned_seeds;
+      std::span<const symbol> m_slots;
+      std::span<const uint32_t> m_seeds;
+      uint64_t m_salt{ 0 };
+      size_t m_size{ 0 };
     };
 
-    class command //: public hashable
+    // the one char flags of a command, so a cluster of them (-xzvf) is checked and saved without looking each
+    // char up in the symbol table: a bit per ascii char with the flag handles of the set bits in char order
+    // (a char's handle is at the count of the bits below it) and the few non ascii ones sorted by code point
+    class flag_chars
     {
     public:
-      enum class state 
-      {
-        not_found, not_convertable, no_value
-      };
-    public: 
-      bool has_value() const 
-      {
-        return !m_value.empty();
-      }
+      flag_chars() = default;
 
-      const std::string& get_raw() const
+      // flags is indexed by flag handle, the ones that aren't one char can't be in a cluster
+      explicit flag_chars(std::span<const std::string_view> flags)
       {
-        return m_value;
+        std::array<uint32_t, 128> handles{};
+        for(size_t i = 0; i < flags.size(); i++)
+        {
+          if(!utf8::is_single_char(flags[i]))
+            continue;
+          const auto c = static_cast<uint8_t>(flags[i][0]);
+          if(c < 0x80)
+          {
+            m_ascii[c / 64] |= uint64_t{ 1 } << (c % 64);
+            handles[c] = static_cast<uint32_t>(i);
+          }
+          else
+          {
+            size_t pos = 0;
+            m_wide.push_back({ utf8::decode(flags[i], pos), static_cast<uint32_t>(i) });
+          }
+        }
+        for(size_t c = 0; c < 128; c++)
+        {
+          if(has(static_cast<uint8_t>(c)))
+            m_handles.push_back(handles[c]);
+        }
+        std::ranges::sort(m_wide);
       }
 
-      template <typename T>
-      std::expected<T, state> get() const
+      // true if every char of cluster is a flag (a bit test a char for ascii ones)
+      bool all(std::string_view cluster) const
       {
-        if(!m_value.empty())
+        if(cluster.empty())
+          return false;
+        for(size_t pos = 0; pos < cluster.size();)
         {
-          auto r = get<T>(m_value);
-          if(r.second)
-            return r.first;
-
-          return std::unexpected(state::not_convertable);
-        } 
-        return std::unexpected(state::no_value);
+          const auto c = static_cast<uint8_t>(cluster[pos]);
+          if(c < 0x80)
+          {
+            if(!has(c))
+              return false;
+            pos++;
+            continue;
+          }
+          const auto start = pos;
+          if(!utf8::advance_one_char(cluster, pos) || find_wide(cluster, start) == nullptr)
+            return false;
+        }
+        return true;
       }
-      
-      // allow both '--opt [opt1, opt2, opt3]' and '--opt opt1 opt2 opt3'
-      template <typename T>
-      std::expected<T, void> get_vector() const
+
+      // calls fun with the flag handle of each char of cluster in order, cluster must be all() flags
+      template <typename FUN>
+      void each(std::string_view cluster, FUN&& fun) const
       {
-        //FIXME: D.R.Y
-        if(m_value.empty())
-          return std::unexpected(state::no_value);
-      
-        std::vector<T> vec;
-        size_t last_d = 0;
-        for(auto i = 0; i < m_value.size(); i++)
+        for(size_t pos = 0; pos < cluster.size();)
         {
-          if(m_value[i] == ' ')
+          const auto c = static_cast<uint8_t>(cluster[pos]);
+          if(c < 0x80)
           {
-            auto r = get<T>(m_value.substr(last_d, i));
-            if(r.second)
-            {
-              vec.emplace_back(r.first);
-              last_d = i;
-            }
-            else 
-            {
-              return std::unexpected(state::no_value);
-            }
+            fun(m_handles[rank(c)]);
+            pos++;
+            continue;
           }
+          fun(find_wide(cluster, pos)->second);
+          utf8::advance_one_char(cluster, pos);
         }
-        
-        if(last_d < m_value.size()) 
-        {
-          auto r = get<T>(m_value.substr(last_d));
-          if (r.second) vec.emplace_back(r.first);
-        }
-
-        return vec;
       }
-
-      std::expected<std::reference_wrapper<command>, state> get_command(const std::string& name)
+    private:
+      bool has(uint8_t c) const
       {
-        const auto cmd_it = m_commands.find(name);
-        if(m_commands.end() != cmd_it)
-          return std::ref(cmd_it->second);
-
-        return std::unexpected(state::not_found);
+        return (m_ascii[c / 64] >> (c % 64) & 1) != 0;
       }
 
-      std::expected<std::reference_wrapper<option>, state> get_option(const std::string& name)
+      // the set bits below c
+      size_t rank(uint8_t c) const
       {
-        const auto opt_it = m_options.find(name);
-        if(m_options.end() != opt_it)
-          return std::ref(opt_it->second);
-
-        return std::unexpected(state::not_found);
+        const uint64_t below = (uint64_t{ 1 } << (c % 64)) - 1;
+        return c < 64 ? std::popcount(m_ascii[0] & below) : std::popcount(m_ascii[0]) + std::popcount(m_ascii[1] & below);
       }
 
-      std::expected<std::reference_wrapper<flag>, state> get_flag(const std::string& name)
+      const std::pair<utf8::code_point, uint32_t>* find_wide(std::string_view cluster, size_t pos) const
       {
-        const auto flag_it = m_flags.find(name);
-        if(m_flags.end() != flag_it)
-          return std::ref(flag_it->second);
-
-        return std::unexpected(state::not_found);
+        const auto cp = utf8::decode(cluster, pos);
+        const auto it = std::ranges::lower_bound(m_wide, cp, {}, &std::pair<utf8::code_point, uint32_t>::first);
+        return it != m_wide.end() && it->first == cp ? &*it : nullptr;
       }
+    private:
+      std::array<uint64_t, 2> m_ascii{};
+      std::vector<uint32_t> m_handles; // by rank
+      std::vector<std::pair<utf8::code_point, uint32_t>> m_wide;
+    };
 
-      const std::unordered_map<std::string, command>& get_subcommands() const
+    constexpr std::string_view token_type_to_string(const token_type tt)
+    {
+      using namespace std::string_view_literals;
+      switch(tt)
       {
-        return m_commands;
+        //case token_type::illegal:          return "illegal"sv;
+        case token_type::eof:              return "eof"sv;
+        case token_type::identifire:       return "identifire"sv;
+        //case token_type::number:           return "number"sv;
+        case token_type::string:           return "string"sv;
+        case token_type::space:            return "space"sv;
+        case token_type::assign:           return "assign"sv;
+        case token_type::delimiter:        return "delimiter"sv;
+        case token_type::double_delimiter: return "double_delimiter"sv;
+        //default:                           return "unknown"sv;
       }
+    }
 
-      const std::unordered_map<std::string, option>& get_options() const 
+    // what an ascii char is to the lexer, one table lookup instead of isspace (locale dependent
+    // and it was given the low byte of a code point) and a search of the delimiter set
+    class char_classes
+    {
+    public:
+      enum : uint8_t
       {
-        return m_options;
-      } 
+        none = 0, space = 1 << 0, delimiter = 1 << 1
+      };
+    public:
+      char_classes() = default;
+      explicit char_classes(const std::unordered_set<std::string_view>& delimiters)
+      {
+        for(const auto c : std::string_view{ " \t\n\v\f\r" })
+          m_table[static_cast<uint8_t>(c)] |= space;
+        for(const auto d : delimiters)
+        {
+          if(d.size() == 1 && static_cast<uint8_t>(d[0]) < 0x80)
+            m_table[static_cast<uint8_t>(d[0])] |= delimiter;
+          else
+            m_wide_delimiters = true;
+        }
+      }
 
-      const std::unordered_map<std::string, flag>& get_flags() const 
+      // non ascii code points have no class
+      bool is(code_point cp, uint8_t cls) const
       {
-        return m_flags;
+        return cp < 0x80 && (m_table[cp] & cls) != 0;
       }
 
-      //bool operator == (const command& cmd) const
-      //{
-      //  return m_name == cmd.m_name;
-      //}
-    //private:
-      command() = default;
-      //explicit command(std::string_view name, std::string_view val = "")
-      //  : m_name(name), m_value(val)
-      //{ 
-      //}
-    private:
-      //std::string m_name;
-      std::string m_value;
-      std::unordered_map<std::string, command> m_commands;
-      std::unordered_map<std::string, option> m_options;
-      std::unordered_map<std::string, flag> m_flags;
+      // true if some delimiter isn't a single ascii char (those are looked up in the set)
+      bool has_wide_delimiters() const
+      {
+        return m_wide_delimiters;
+      }
     private:
-      friend class parser;
-      friend class parse_resault;
+      std::array<uint8_t, 128> m_table{};
+      bool m_wide_delimiters{ false };
     };
 
-    class parse_resault 
+    // simdjson style stage 1: 64 byte blocks of the input are classified into bitmasks
+    // (bit i is byte i of the block) of the bytes that end tokens, so the lexer finds the end
+    // of an identifier, a string or a run of spaces with a count trailing zeros instead of decoding
+    // every char in between, blocks are classified once as the lexer walks over them
+    // all of these chars are ascii so they can never be a part of a multi byte sequence
+    class structural_scanner
     {
     public:
-      parse_resault() = default;
+      struct masks
+      {
+        uint64_t space;      // ' ' '\t' '\n' '\v' '\f' '\r'
+        uint64_t ident_end;  // space '=' '\0'
+        uint64_t assign_end; // '=' '\0' (argv words, spaces don't end them)
+        uint64_t squote_end; // '\'' '\0'
+        uint64_t dquote_end; // '"' '\\' '\0'
+      };
 
-      bool has_error() const;
-    public:
-      command root;
-    };
+      using mask_kind = uint64_t masks::*;
+      using classify_fn = masks (*)(const char*);
 
-    class parser 
-    {
-    public: 
-      parser() = default;
-      
-      // build stage(pre parse)
-      
-      inline command_builder& add_subcommand(const std::string& name)
+      void reset(std::string_view input)
       {
-        return m_root.add_subcommand(name);
+        m_input = input;
+        m_block = npos;
       }
-      
-      inline option_builder& add_option(const std::string& name)
+
+      // the position of the first byte at or after pos that is in kind (the input size if none)
+      size_t find(size_t pos, mask_kind kind)
       {
-        return m_root.add_option(name);
+        return search(pos, kind, false);
       }
 
-      inline void add_flag(const std::string& name)
+      // the position of the first byte at or after pos that isn't in kind (the input size if none)
+      size_t skip(size_t pos, mask_kind kind)
       {
-        m_root.add_flag(name);
+        return search(pos, kind, true);
       }
 
-      // parse function(only one function)
-      // TODO: windowsss(not utf-8)
-      parse_resault parse(int argc, char** argv)
+      static masks classify_scalar(const char* p)
       {
-        auto args_str = clara::detail::join_args(argc, argv);
-        m_lx = detail::lexer{ args_str };
-
-        
-        while(m_current_token.type != detail::token_type::eof)
+        masks m{};
+        for(size_t i = 0; i < 64; i++)
         {
-          if(!parse_one())
-            advance();
-          for(auto f : m_to_parse)
-            if(f())
-              advance();
-          m_to_parse.clear();
+          const auto c = static_cast<uint8_t>(p[i]);
+          const uint64_t bit = uint64_t{ 1 } << i;
+          const bool space = c == ' ' || (c >= '\t' && c <= '\r');
+          m.space |= space ? bit : 0;
+          m.ident_end |= space || c == '=' || c == 0 ? bit : 0;
+          m.assign_end |= c == '=' || c == 0 ? bit : 0;
+          m.squote_end |= c == '\'' || c == 0 ? bit : 0;
+          m.dquote_end |= c == '"' || c == '\\' || c == 0 ? bit : 0;
         }
-        return m_resault; 
+        return m;
       }
-    private:
-      enum class single_delimiter_ : uint8_t
-      {
-        invalid, alias, flag, mutliflag
-      };
 
-      enum class double_delimiter_ : uint8_t
+#if defined(CLARA_X86_SIMD)
+      __attribute__((target("sse4.2")))
+      static masks classify_sse42(const char* p)
       {
-        invalid, alias, option
-      };
+        masks m{};
+        for(size_t i = 0; i < 4; i++)
+        {
+          const __m128i in = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + 16 * i));
+          // '\t'..'\r' is one range, in - '\t' <= 4 unsigned
+          const __m128i off = _mm_sub_epi8(in, _mm_set1_epi8('\t'));
+          const __m128i space = _mm_or_si128(_mm_cmpeq_epi8(in, _mm_set1_epi8(' ')), 
+                                             _mm_cmpeq_epi8(_mm_min_epu8(off, _mm_set1_epi8(4)), off));
+          const __m128i zero = _mm_cmpeq_epi8(in, _mm_setzero_si128());
+          const __m128i assign = _mm_or_si128(_mm_cmpeq_epi8(in, _mm_set1_epi8('=')), zero);
+          const __m128i squote = _mm_or_si128(_mm_cmpeq_epi8(in, _mm_set1_epi8('\'')), zero);
+          const __m128i dquote = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(in, _mm_set1_epi8('"')), 
+                                                           _mm_cmpeq_epi8(in, _mm_set1_epi8('\\'))), zero);
+          const size_t shift = 16 * i;
+          m.space |= uint64_t{ static_cast<uint16_t>(_mm_movemask_epi8(space)) } << shift;
+          m.ident_end |= uint64_t{ static_cast<uint16_t>(_mm_movemask_epi8(_mm_or_si128(space, assign))) } << shift;
+          m.assign_end |= uint64_t{ static_cast<uint16_t>(_mm_movemask_epi8(assign)) } << shift;
+          m.squote_end |= uint64_t{ static_cast<uint16_t>(_mm_movemask_epi8(squote)) } << shift;
+          m.dquote_end |= uint64_t{ static_cast<uint16_t>(_mm_movemask_epi8(dquote)) } << shift;
+        }
+        return m;
+      }
 
-      enum class identifier : bool 
+      __attribute__((target("avx2")))
+      static masks classify_avx2(const char* p)
       {
-        invalid, subcommand
-      };
-    private:
-      void advance()
+        masks m{};
+        for(size_t i = 0; i < 2; i++)
+        {
+          const __m256i in = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + 32 * i));
+          const __m256i off = _mm256_sub_epi8(in, _mm256_set1_epi8('\t'));
+          const __m256i space = _mm256_or_si256(_mm256_cmpeq_epi8(in, _mm256_set1_epi8(' ')), 
+                                                _mm256_cmpeq_epi8(_mm256_min_epu8(off, _mm256_set1_epi8(4)), off));
+          const __m256i zero = _mm256_cmpeq_epi8(in, _mm256_setzero_si256());
+          const __m256i assign = _mm256_or_si256(_mm256_cmpeq_epi8(in, _mm256_set1_epi8('=')), zero);
+          const __m256i squote = _mm256_or_si256(_mm256_cmpeq_epi8(in, _mm256_set1_epi8('\'')), zero);
+          const __m256i dquote = _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(in, _mm256_set1_epi8('"')), 
+                                                                 _mm256_cmpeq_epi8(in, _mm256_set1_epi8('\\'))), zero);
+          const size_t shift = 32 * i;
+          m.space |= uint64_t{ static_cast<uint32_t>(_mm256_movemask_epi8(space)) } << shift;
+          m.ident_end |= uint64_t{ static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_or_si256(space, assign))) } << shift;
+          m.assign_end |= uint64_t{ static_cast<uint32_t>(_mm256_movemask_epi8(assign)) } << shift;
+          m.squote_end |= uint64_t{ static_cast<uint32_t>(_mm256_movemask_epi8(squote)) } << shift;
+          m.dquote_end |= uint64_t{ static_cast<uint32_t>(_mm256_movemask_epi8(dquote)) } << shift;
+        }
+        return m;
+      }
+#endif // defined(CLARA_X86_SIMD)
+
+      // the best kernel this cpu has, picked once
+      static classify_fn best_classifier()
       {
-        m_current_token = m_peek_token;
-        m_peek_token = m_lx.advance();
+        static const classify_fn fn = [] () -> classify_fn {
+#if defined(CLARA_X86_SIMD)
+          __builtin_cpu_init();
+          if(__builtin_cpu_supports("avx2"))
+            return classify_avx2;
+          if(__builtin_cpu_supports("sse4.2"))
+            return classify_sse42;
+#endif
+          return classify_scalar;
+        }();
+        return fn;
       }
+    private:
+      static constexpr size_t npos = static_cast<size_t>(-1);
 
-      // returns true if it could parse this current token and changes the state to the next tokens 
-      // and returns false if it couldn't parse the current token and it requires the state to be advanced
-      bool parse_one()
+      const masks& block(size_t b)
       {
-        using detail::token_type;
-        switch(m_current_token.type)
+        if(b != m_block)
         {
-          case token_type::delimiter:
-          {
-            D_PRINT("parse_delimiter start" << m_current_token.literal << " ");
-            auto d = parse_delimiter();
-            D_PRINT("parse_delimiter end");
-            return d;
-          }
-          case token_type::double_delimiter:
-          {
-            D_PRINT("parse_double_delimiter start" << m_current_token.literal << " ");
-            auto d = parse_double_delimiter();
-            D_PRINT("parse_double_delimiter end");
-            return d;
-          }
-          case token_type::identifire:
-          {  
-            D_PRINT("parse_identifire start" << m_current_token.literal << " ");
-            auto d = parse_identifire();
-            D_PRINT("parse_identifire end");
-            return d;
-          }
-          case token_type::space:
-          {
-            D_PRINT("space: " << m_current_token.literal << " ");
-            return false;
-          }
-          case token_type::assign:
+          const size_t start = b * 64;
+          if(start + 64 <= m_input.size())
           {
-            D_PRINT("assign escaped parsing: " << m_current_token.literal);
-            return false;
+            m_masks = best_classifier()(m_input.data() + start);
           }
-          default:
+          else
           {
-            D_PRINT("unknown token cant parse");
-            D_PRINT("token: type: " << uint32_t(m_current_token.type) << " literal: '" << m_current_token.literal << "'");
-            return false;
+            // the last block, padded with '\0' (it ends everything but spaces, the size clamps it)
+            char tail[64] = {};
+            std::memcpy(tail, m_input.data() + start, m_input.size() - start);
+            m_masks = best_classifier()(tail);
           }
+          m_block = b;
         }
+        return m_masks;
       }
 
-      // returns true if it can parse the delimiter and the next tokne and it's requirement(s)
-      // returns false otherwise and it requires the token to be advanced externally
-      bool parse_delimiter_v0()
+      size_t search(size_t pos, mask_kind kind, bool invert)
       {
-        if(!expect_next(detail::token_type::identifire))
+        while(pos < m_input.size())
         {
-          // return at the delimiter token require advancment
-          return false; //TODO: error
+          const size_t b = pos / 64;
+          uint64_t m = block(b).*kind;
+          if(invert)
+            m = ~m;
+          m &= ~uint64_t{ 0 } << (pos % 64);
+          if(m != 0)
+            return std::min(b * 64 + std::countr_zero(m), m_input.size());
+          pos = (b + 1) * 64;
         }
+        return m_input.size();
+      }
+    private:
+      std::string_view m_input;
+      size_t m_block{ npos };
+      masks m_masks{};
+    };
 
-        // now we are at identifier token we will try to parse it and if we fail 
-        // we will return at it and we will require advancment
+    // a number of a value list split into its decimal digits, '[+-]digits[.digits]' with at most 16 digits,
+    // what it is is decided by the type it's converted to (parse::convert_list)
+    struct decimal
+    {
+      uint64_t digits{ 0 }; // all the digits as one integer (the '.' removed)
+      uint32_t scale{ 0 };  // how many of them are after the '.'
+      bool negative{ false };
+    };
 
-        //FIXME: there is a repeated alias check D.R.Y
+    // the kernels of bulk list conversion, the values are in raw separated by one byte and ends has where each
+    // one ends (see nth_value), a kernel splits values [first, last) into out (out[0] is value first) and stops at
+    // the first one that isn't a plain decimal it can do (exponents, more than 16 digits...), that one is left to
+    // from_chars, the vector kernels turn 16 digits into an integer with multiply adds instead of a loop 
+    class decimal_parser
+    {
+    public:
+      // returns the index of the value it stopped at (last if it did all of them)
+      using parse_fn = size_t (*)(std::string_view raw, const uint32_t* ends, size_t first, size_t last, decimal* out);
 
-        if(utf8::is_single_char(m_current_token.literal)) //single char => it's either an alias or a real flag
-        {
-          // check if it's an alias
-          const auto& alias_it = m_current_command->m_options_aliases.find(m_current_token.literal);
-          if(m_current_command->m_options_aliases.end() != alias_it)
-          {
-            // if it's an alias resolve it and forward resolving state
-            return resolve_alias(true, alias_it);
-          }
-          
-          // it's not an alias so it might be a flag
-          
-          // flag check
-          const auto& flag_it = m_current_command->m_flags.find(m_current_token.literal);
-          if(m_current_command->m_flags.end() != flag_it)
-          {
-            // so it's a flag save it and advance then return true
-            //flag f{};
-            //m_current_resault_command->m_flags[m_current_token.literal] = f;
-            save_flag(m_current_token.literal, {});
-            advance();
-            return true;
-          }
-          // not a flag require advancment
-          return false;
-        }
-        else // multi char it's either an alias or multiple flags
+      static size_t parse_scalar(std::string_view raw, const uint32_t* ends, size_t first, size_t last, decimal* out)
+      {
+        for(size_t i = first; i < last; i++)
         {
-          // alias check
-          const auto& alias_it = m_current_command->m_options_aliases.find(m_current_token.literal);
-          if(m_current_command->m_options_aliases.end() != alias_it)
-          {
-            // if it's an alias resolve it and forward resolving state
-            return resolve_alias(true, alias_it);
-          }
-          
-          // so it must be multi-flag or (error)
-          return resolve_multiflag();
+          const size_t begin = i == 0 ? 0 : ends[i - 1] + 1;
+          if(!parse_one(raw.substr(begin, ends[i] - begin), out[i - first]))
+            return i;
         }
+        return last;
       }
 
-      bool parse_delimiter()
+#if defined(CLARA_X86_SIMD)
+      __attribute__((target("sse4.2")))
+      static size_t parse_sse42(std::string_view raw, const uint32_t* ends, size_t first, size_t last, decimal* out)
       {
-        auto tp = get_single_delimiter_type();
-        
-        if(!expect_next(detail::token_type::identifire))
+        const __m128i iota = _mm_setr_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+        for(size_t i = first; i < last; i++)
         {
-          // return at the delimiter token require advancment
-          return false; //TODO: error
+          size_t begin = i == 0 ? 0 : ends[i - 1] + 1;
+          auto& d = out[i - first];
+          if(!sign(raw, begin, ends[i], d))
+            return i;
+          const size_t n = ends[i] - begin;
+          char tmp[16];
+          const __m128i in = _mm_loadu_si128(reinterpret_cast<const __m128i*>(load(raw, begin, tmp)));
+          const __m128i v = _mm_sub_epi8(in, _mm_set1_epi8('0'));
+          const uint32_t is_digit = static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_min_epu8(v, _mm_set1_epi8(9)), v)));
+          uint32_t dot = 16;
+          if(!split(raw.data() + begin, n, is_digit, dot, d))
+            return i;
+
+          // lane j of the result is digit j - (16 - count) (zero if negative) skipping the '.'
+          const __m128i k = _mm_add_epi8(iota, _mm_set1_epi8(static_cast<char>(n - (dot != 16) - 16)));
+          const __m128i src = _mm_sub_epi8(k, _mm_cmpgt_epi8(k, _mm_set1_epi8(static_cast<char>(dot - 1))));
+          const __m128i x = _mm_shuffle_epi8(v, src);
+          // 16 digits -> 8 of 2 -> 4 of 4 -> 2 of 8 -> 1
+          const __m128i t1 = _mm_maddubs_epi16(x, _mm_setr_epi8(10, 1, 10, 1, 10, 1, 10, 1, 10, 1, 10, 1, 10, 1, 10, 1));
+          const __m128i t2 = _mm_madd_epi16(t1, _mm_setr_epi16(100, 1, 100, 1, 100, 1, 100, 1));
+          const __m128i t3 = _mm_madd_epi16(_mm_packus_epi32(t2, t2), _mm_setr_epi16(10000, 1, 10000, 1, 10000, 1, 10000, 1));
+          d.digits = static_cast<uint64_t>(static_cast<uint32_t>(_mm_cvtsi128_si32(t3))) * 100000000 
+                   + static_cast<uint32_t>(_mm_extract_epi32(t3, 1));
         }
+        return last;
+      }
 
-        switch(tp)
+      // two values a step, one in each 128 bit lane (shuffles and multiply adds don't cross lanes)
+      __attribute__((target("avx2")))
+      static size_t parse_avx2(std::string_view raw, const uint32_t* ends, size_t first, size_t last, decimal* out)
+      {
+        const __m256i iota = _mm256_setr_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 
+                                              0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+        size_t i = first;
+        for(; i + 1 < last; i += 2)
         {
-          case single_delimiter_::flag:
-          {
-            save_flag(m_current_token.literal, {});
-            advance();
-            return true;
-          }
-          case single_delimiter_::alias:
-          {
-            const auto& alias_it = m_current_command->m_options_aliases.find(m_current_token.literal);
-            return resolve_alias(true, alias_it);
-          }
-          case single_delimiter_::mutliflag:
-          {
-            return resolve_multiflag();
-          }
-          case single_delimiter_::invalid:
-          default:
-          {
-            return false;
-          }
+          size_t begin_a = i == 0 ? 0 : ends[i - 1] + 1;
+          size_t begin_b = ends[i] + 1;
+          auto& a = out[i - first];
+          auto& b = out[i + 1 - first];
+          if(!sign(raw, begin_a, ends[i], a))
+            return i;
+          if(!sign(raw, begin_b, ends[i + 1], b))
+            return parse_sse42(raw, ends, i, i + 1, out + (i - first));
+          const size_t n_a = ends[i] - begin_a;
+          const size_t n_b = ends[i + 1] - begin_b;
+          char tmp_a[16];
+          char tmp_b[16];
+          const __m256i in = _mm256_loadu2_m128i(reinterpret_cast<const __m128i*>(load(raw, begin_b, tmp_b)), 
+                                                 reinterpret_cast<const __m128i*>(load(raw, begin_a, tmp_a)));
+          const __m256i v = _mm256_sub_epi8(in, _mm256_set1_epi8('0'));
+          const uint32_t is_digit = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_min_epu8(v, _mm256_set1_epi8(9)), v)));
+          uint32_t dot_a = 16;
+          uint32_t dot_b = 16;
+          if(!split(raw.data() + begin_a, n_a, is_digit & 0xffff, dot_a, a))
+            return i;
+          if(!split(raw.data() + begin_b, n_b, is_digit >> 16, dot_b, b))
+            return parse_sse42(raw, ends, i, i + 1, out + (i - first));
+
+          const __m256i k = _mm256_add_epi8(iota, _mm256_setr_m128i(_mm_set1_epi8(static_cast<char>(n_a - (dot_a != 16) - 16)), 
+                                                                    _mm_set1_epi8(static_cast<char>(n_b - (dot_b != 16) - 16))));
+          const __m256i dots = _mm256_setr_m128i(_mm_set1_epi8(static_cast<char>(dot_a - 1)), _mm_set1_epi8(static_cast<char>(dot_b - 1)));
+          const __m256i src = _mm256_sub_epi8(k, _mm256_cmpgt_epi8(k, dots));
+          const __m256i x = _mm256_shuffle_epi8(v, src);
+          const __m256i t1 = _mm256_maddubs_epi16(x, _mm256_setr_epi8(10, 1, 10, 1, 10, 1, 10, 1, 10, 1, 10, 1, 10, 1, 10, 1, 
+                                                                      10, 1, 10, 1, 10, 1, 10, 1, 10, 1, 10, 1, 10, 1, 10, 1));
+          const __m256i t2 = _mm256_madd_epi16(t1, _mm256_setr_epi16(100, 1, 100, 1, 100, 1, 100, 1, 100, 1, 100, 1, 100, 1, 100, 1));
+          const __m256i t3 = _mm256_madd_epi16(_mm256_packus_epi32(t2, t2), 
+                                               _mm256_setr_epi16(10000, 1, 10000, 1, 10000, 1, 10000, 1, 10000, 1, 10000, 1, 10000, 1, 10000, 1));
+          a.digits = static_cast<uint64_t>(static_cast<uint32_t>(_mm256_extract_epi32(t3, 0))) * 100000000 
+                   + static_cast<uint32_t>(_mm256_extract_epi32(t3, 1));
+          b.digits = static_cast<uint64_t>(static_cast<uint32_t>(_mm256_extract_epi32(t3, 4))) * 100000000 
+                   + static_cast<uint32_t>(_mm256_extract_epi32(t3, 5));
         }
+        if(i < last)
+          return parse_sse42(raw, ends, i, last, out + (i - first));
+        return last;
       }
+#endif // defined(CLARA_X86_SIMD)
 
-      // returns true if it can parse the double_delimiter and the next tokne and it's requirement(s)
-      // returns false otherwise and it requires the token to be advanced externally
-      bool parse_double_delimiter_v0()
+      // the best kernel this cpu has, picked once
+      static parse_fn best_parser()
       {
-        if(!expect_next(detail::token_type::identifire))
-        {
-          // return at the double_delimiter token require advancment
+        static const parse_fn fn = [] () -> parse_fn {
+#if defined(CLARA_X86_SIMD)
+          __builtin_cpu_init();
+          if(__builtin_cpu_supports("avx2"))
+            return parse_avx2;
+          if(__builtin_cpu_supports("sse4.2"))
+            return parse_sse42;
+#endif
+          return parse_scalar;
+        }();
+        return fn;
+      }
+    private:
+      static bool parse_one(std::string_view value, decimal& d)
+      {
+        size_t begin = 0;
+        if(!sign(value, begin, value.size(), d))
           return false;
-        }
-
-        // alias check
-        const auto& alias_it = m_current_command->m_options_aliases.find(m_current_token.literal);
-        if(m_current_command->m_options_aliases.end() != alias_it)
+        value.remove_prefix(begin);
+        uint32_t is_digit = 0;
+        for(size_t j = 0; j < value.size(); j++)
+          is_digit |= static_cast<uint32_t>(static_cast<uint8_t>(value[j] - '0') <= 9) << j;
+        uint32_t dot = 16;
+        if(!split(value.data(), value.size(), is_digit, dot, d))
+          return false;
+        d.digits = 0;
+        for(const char c : value)
         {
-          // if it's an alias resolve it and forward the resolving state
-          return resolve_alias(false, alias_it);
+          if(c != '.')
+            d.digits = d.digits * 10 + static_cast<uint64_t>(c - '0');
         }
-        
-        // it's not an alias so check if it's a real option
-        const auto& opt_it = m_current_command->m_options.find(m_current_token.literal);
-        if(m_current_command->m_options.end() != opt_it)
+        return true;
+      }
+
+      // takes the sign off the value in [begin, end), false if nothing that can be a number is left
+      static bool sign(std::string_view raw, size_t& begin, size_t end, decimal& d)
+      {
+        d.negative = false;
+        if(begin < end && (raw[begin] == '-' || raw[begin] == '+'))
         {
-          // if it's an option resolve it and forward the resolving state
-          return resolve_option(opt_it->first, opt_it->second);
+          d.negative = raw[begin] == '-';
+          begin++;
         }
-        else 
-        {
-          // invalid option require advancment 
+        // 16 chars (a '.' and 15 digits or 16 digits) fit in a vector
+        return end > begin && end - begin <= 16;
+      }
+
+      // checks the value is digits with at most one '.' between two of them (is_digit has a bit per char),
+      // sets where the '.' is (16 if there is none) and the scale
+      static bool split(const char* p, size_t n, uint32_t is_digit, uint32_t& dot, decimal& d)
+      {
+        const uint32_t all = (uint32_t{ 1 } << n) - 1;
+        is_digit &= all;
+        d.scale = 0;
+        if(is_digit == all)
+          return true;
+        dot = static_cast<uint32_t>(std::countr_one(is_digit));
+        if(dot == 0 || dot + 1 >= n || p[dot] != '.' || (is_digit | (uint32_t{ 1 } << dot)) != all)
           return false;
-        }
+        d.scale = static_cast<uint32_t>(n - dot - 1);
+        return true;
       }
 
+      // the 16 bytes at begin, copied when they would be read past the end of raw
+      static const char* load(std::string_view raw, size_t begin, char (&tmp)[16])
+      {
+        if(begin + 16 <= raw.size())
+          return raw.data() + begin;
+        std::memset(tmp, 0, sizeof(tmp));
+        std::memcpy(tmp, raw.data() + begin, raw.size() - begin);
+        return tmp;
+      }
+    };
 
-      bool parse_double_delimiter()
+    // the value of d as T if it's exact (no rounding, in range), otherwise from_chars decides
+    template <typename T>
+    bool from_decimal(const decimal& d, T& out)
+    {
+      if constexpr(std::is_integral_v<T>)
       {
-        // we are now at the delimiter token 
-        
-        if(!expect_next(detail::token_type::identifire))
-        {
-          // return at the double_delimiter token require advancment
+        if(d.scale != 0)
           return false;
-        }
-        
-        // we are now at the identifire after the delimiter 
-
-        auto tp = get_double_dlimiter_type(m_current_token);
-        switch(tp)
-        {
-          case double_delimiter_::alias:
-          {
-            const auto& alias_it = m_current_command->m_options_aliases.find(m_current_token.literal);
-            return resolve_alias(false, alias_it);
-          }
-          case double_delimiter_::option:
+        const int64_t v = d.negative ? -static_cast<int64_t>(d.digits) : static_cast<int64_t>(d.digits);
+        // a "-0" isn't an unsigned for from_chars
+        if(!std::in_range<T>(v) || (std::is_unsigned_v<T> && d.negative))
+          return false;
+        out = static_cast<T>(v);
+        return true;
+      }
+      else 
+      {
+        // both the digits and the power of ten are exact so one division rounds it right
+        constexpr uint32_t max_scale = std::numeric_limits<T>::digits < 53 ? 10 : 22;
+        constexpr auto powers = [] {
+          std::array<T, max_scale + 1> p{};
+          T v = 1;
+          for(auto& e : p)
           {
-            const auto& opt_it = m_current_command->m_options.find(m_current_token.literal);
-            return resolve_option(opt_it->first, opt_it->second);
+            e = v;
+            v *= 10;
           }
-          case double_delimiter_::invalid:
-          default:
+          return p;
+        }();
+        if(d.scale > max_scale || d.digits > (uint64_t{ 1 } << std::min(std::numeric_limits<T>::digits, 63)))
+          return false;
+        const T v = static_cast<T>(d.digits) / powers[d.scale];
+        out = d.negative ? -v : v;
+        return true;
+      }
+    }
+
+    // a whole file as read only memory (see CLARA_MMAP), it's mapped so only the pages that are read are loaded,
+    // moving it doesn't move the bytes
+    class mapped_file
+    {
+    public:
+      mapped_file() = default;
+
+      // nullopt if path can't be opened (or isn't a regular file)
+      static std::optional<mapped_file> open(const char* path)
+      {
+        mapped_file f;
+#if defined(CLARA_MMAP)
+        const int fd = ::open(path, O_RDONLY | O_CLOEXEC);
+        if(fd < 0)
+          return std::nullopt;
+        struct stat st{};
+        if(::fstat(fd, &st) != 0 || !S_ISREG(st.st_mode))
+        {
+          ::close(fd);
+          return std::nullopt;
+        }
+        f.m_size = static_cast<size_t>(st.st_size);
+        if(f.m_size > 0)
+        {
+          void* p = ::mmap(nullptr, f.m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+          if(p == MAP_FAILED)
           {
-            return false;
+            ::close(fd);
+            return std::nullopt;
           }
+          ::madvise(p, f.m_size, MADV_SEQUENTIAL);
+          f.m_data = static_cast<const char*>(p);
+        }
+        ::close(fd); // the mapping keeps the file
+#else
+        std::FILE* file = std::fopen(path, "rb");
+        if(file == nullptr)
+          return std::nullopt;
+        if(std::fseek(file, 0, SEEK_END) != 0)
+        {
+          std::fclose(file);
+          return std::nullopt;
+        }
+        const long size = std::ftell(file);
+        std::rewind(file);
+        if(size < 0)
+        {
+          std::fclose(file);
+          return std::nullopt;
         }
+        f.m_copy = std::make_unique_for_overwrite<char[]>(static_cast<size_t>(size));
+        f.m_size = std::fread(f.m_copy.get(), 1, static_cast<size_t>(size), file);
+        f.m_data = f.m_copy.get();
+        std::fclose(file);
+#endif
+        return f;
       }
 
+      mapped_file(mapped_file&& other) noexcept
+        : m_data(std::exchange(other.m_data, nullptr)), m_size(std::exchange(other.m_size, 0)), m_copy(std::move(other.m_copy))
+      {
+      }
 
-      // returns true if it can parse the identifier and it's requirement(s)
-      // returns false otherwise and it requires the token to be advanced externally
-      bool parse_identifire()
+      mapped_file& operator=(mapped_file&& other) noexcept
       {
-        // stand-alone identifire must be a subcommand 
-        
-        // subcommand check
-        auto sub_it = m_current_command->m_subcommands.find(m_current_token.literal);
-        if(m_current_command->m_subcommands.end() != sub_it)
+        if(this != &other)
         {
-          // it's a subcommand resolve it and forward the resolving state
-          return resolve_command(sub_it->first, sub_it->second);
+          unmap();
+          m_data = std::exchange(other.m_data, nullptr);
+          m_size = std::exchange(other.m_size, 0);
+          m_copy = std::move(other.m_copy);
         }
-        
-        // invalid subcommand require advancment
-        return false;
+        return *this;
       }
 
-      //this function is bad
-      bool resolve_alias(bool is_single_delm_call, const auto& alias_it)
+      ~mapped_file()
       {
-        // if is aliase route to option path
-        if(m_current_command->m_options_aliases.end() != alias_it)
+        unmap();
+      }
+
+      std::string_view view() const
+      {
+        return { m_data, m_size };
+      }
+    private:
+      void unmap()
+      {
+#if defined(CLARA_MMAP)
+        if(m_data != nullptr && !m_copy)
+          ::munmap(const_cast<char*>(m_data), m_size);
+#endif
+        m_data = nullptr;
+      }
+    private:
+      const char* m_data{ nullptr };
+      size_t m_size{ 0 };
+      std::unique_ptr<char[]> m_copy; // the bytes when they are read instead of mapped
+    };
+
+    // how a lexer expands response files and when it lexes on many threads
+    struct lexer_options
+    {
+      size_t response_depth{ 0 };           // how deep '@file' words nest (0 is off)
+      size_t threads{ 1 };                  // threads that lex big line inputs (0 is one per core)
+      size_t parallel_min_bytes{ 1 << 20 }; // inputs shorter than this are lexed on the calling thread
+      bool shell_words{ false };            // lines are split into words like a posix shell does (see shell_words)
+      bool token_array{ false };            // the input is lexed into a token_array before it's parsed
+    };
+
+    class lexer
+    {
+    public:
+      using input_type = std::string_view;
+      using delimiter_set = std::unordered_set<std::string_view>;
+    public:
+      using args_type = std::span<char* const>;
+    public:
+      lexer() = default;
+      // ds must outlive the lexer, see lexer_options for '@file' words (enter_response_file) and threads (lex_parallel)
+      lexer(const input_type input, const delimiter_set& ds = default_delimiters(), const lexer_options& opts = {})
+        : m_input(input), m_delimiters(&ds), m_classes(classes_of(ds)), m_options(opts)
+      {
+        // validated once here (simd for long inputs) so lexing doesn't check each char
+        m_valid_utf8 = utf8::is_valid_utf8(m_input);
+        m_scanner.reset(m_input);
+        m_current = read_char();
+        if(is_big(m_input))
+          lex_parallel();
+      }
+
+      // argv mode: every element is already a word (the shell did the splitting for us)
+      // so we lex them in place one after the other, the end of each word is reported
+      // as a space token and spaces inside of a word are just part of it
+      lexer(const args_type args, const delimiter_set& ds = default_delimiters(), const lexer_options& opts = {})
+        : m_args(args), m_args_mode(true), m_delimiters(&ds), m_classes(classes_of(ds)), m_options(opts)
+      {
+        next_arg();
+        m_current = read_char();
+      }
+
+      // same as above for words that are views (e.g. of a line split by shell_words)
+      lexer(const std::span<const std::string_view> words, const delimiter_set& ds = default_delimiters(), const lexer_options& opts = {})
+        : m_words(words), m_args_mode(true), m_delimiters(&ds), m_classes(classes_of(ds)), m_options(opts)
+      {
+        next_arg();
+        m_current = read_char();
+      }
+
+      // tokens that were already lexed (by a stream_lexer), their literals must outlive the lexer
+      lexer(std::vector<token>&& tokens, bool valid_utf8)
+        : m_valid_utf8(valid_utf8)
+      {
+        m_runs.push_back({ std::move(tokens), 0 });
+      }
+
+      // false if any of the input (so far) wasn't valid utf-8
+      bool is_valid_utf8() const
+      {
+        return m_valid_utf8;
+      }
+
+      // the '@file' words that were nested deeper than the limit (so they were lexed as they are)
+      std::span<const std::string_view> too_deep_response_files() const
+      {
+        return m_too_deep;
+      }
+
+      // shared by all lexers so making a lexer doesn't allocate a set
+      static const delimiter_set& default_delimiters()
+      {
+        static const delimiter_set ds{ 
+          CLARA_DELIMITER
+        };
+        return ds;
+      }
+
+      token advance()
+      {
+        using namespace std::string_view_literals;
+
+        // an input that was lexed on many threads (once it's done m_current is its end)
+        for(; m_run < m_runs.size(); m_run++)
         {
-          //TODO: missmatch check
-          switch(m_current_command->m_options[alias_it->second].m_alias_opts)
+          auto& r = m_runs[m_run];
+          if(r.next < r.tokens.size())
+            return r.tokens[r.next++];
+        }
+        
+        consume_whitespace();
+        token tok;
+
+        switch(m_current)
+        {
+          case U'=':
           {
-            case option_builder::alias_options::off:
+            //skip it
+            //read_char();
+            //return advance();
+            tok = { token_type::assign, "="sv };
+            break;
+          }
+          case U'\'':
+          case U'"':
+          {
+            if(m_args_mode)
+              return read_word(); // the shell already took the quotes out, the ones left are part of the word
+            tok.type = token_type::string;
+            tok.literal = read_string(m_current);
+            break;
+          }
+          case 0:
+          {  
+            if(m_empty_word) // an empty argv word is an empty value (like "" on a line)
             {
-              advance();
-              return true;
+              m_empty_word = false;
+              tok = { token_type::string, ""sv };
+              break;
             }
-            case option_builder::alias_options::double_delimiter:
+            if(next_arg() || leave_response_file()) // end of an argv word or of a response file
             {
-              if(!is_single_delm_call)
-                return resolve_option(alias_it->second, m_current_command->m_options[alias_it->second]);
+              tok = { token_type::space, " "sv };
+              m_current = read_char();
+              return tok;
             }
-            case option_builder::alias_options::single_delimiter:
+            tok = { token_type::eof, ""sv };
+            break;
+          }
+          case U' ':
+          case U'\t':
+          case U'\n':
+          case U'\v':
+          case U'\f':
+          case U'\r':
+          {
+            if(!m_args_mode)
             {
-              if(is_single_delm_call)
-                return resolve_option(alias_it->second, m_current_command->m_options[alias_it->second]);
+              tok = { token_type::space, " "sv };
+              break;
+            }
+            [[fallthrough]]; // whitespace inside of an argv word is part of it
+          }
+          default:
+          {
+            //always return from here on, we don't need to read_char at the end
+            if(m_current == U'@' && !m_args_mode && m_options.response_depth != 0 && at_word_start())
+            {
+              const auto end = m_scanner.find(m_position, &structural_scanner::masks::space);
+              const auto depth = m_frames.size();
+              if(enter_response_file(m_input.substr(m_position, end - m_position), end))
+              {
+                // lex its first token (an empty file is skipped with the spaces after it)
+                if(m_frames.size() == depth)
+                  m_read_position = m_scanner.skip(end, &structural_scanner::masks::space);
+                m_current = read_char();
+                return advance();
+              }
+            }
+            if(is_delimiter(m_current, current_char()))
+            {
+              const auto start = m_position;
+              const auto& next = peek();
+              if(is_delimiter(next.cp, m_input.substr(m_read_position, next.end - m_read_position)))
+              {
+                tok.type = token_type::double_delimiter;
+                read_char(); //skip the next delimiter (it's part of double_delimiter)
+              }
+              else 
+              {
+                tok.type = token_type::delimiter;
+              }
+              tok.literal = m_input.substr(start, m_read_position - start);
+              m_current = read_char();
+              return tok;
+            }
+            else // the input is already validated (invalid sequences decode to '?')
+            {
+              return read_word();
             }
+            //if(utf8::is_number(utf8::encode(m_current)))
+            //{
+            //  //TODO: floats/ints/uints //or just number as double idk
+            //  tok.literal = read_number();
+            //  tok.type = token_type::number;
+            //  return tok;
+            //}
+            //{
+            //  //convert to utf-8 for the literal 
+            //  std::string literal;
+            //  if(m_current <= 0x7f)
+            //    literal = std::string(1, static_cast<char>(m_current));
+            //  else //TODO: FIXME: proper utf-8 encoding
+            //    literal = utf8::encode(m_current);
+            //  
+            //  tok = { token_type::illegal, literal };
+            //}
+            break;
+          }
+        }
+        m_current = read_char();
+        return tok;
+      }
+    private:
+      code_point read_char()
+      {
+        if(m_read_position >= m_input.size())
+        {
+          m_position = m_input.size(); // so the last read_xxx includes the last char
+          return 0; //eof
+        }
+
+        code_point ch = 0;
+        size_t pos = m_read_position;
+        if(m_next.position == m_read_position) // already decoded by peek()
+        {
+          ch = m_next.cp;
+          pos = m_next.end;
+        }
+        else
+        {
+          ch = decode(pos);
+        }
+        m_position = m_read_position;
+        m_read_position = pos;
+        return ch;
+      }
+
+      // the char after m_current, decoded once for both peek() and the read_char() after it
+      struct lookahead
+      {
+        size_t position{ static_cast<size_t>(-1) };
+        size_t end{ 0 };
+        code_point cp{ 0 };
+      };
+
+      const lookahead& peek()
+      {
+        if(m_next.position != m_read_position)
+        {
+          size_t pos = m_read_position;
+          const auto cp = m_read_position < m_input.size() ? decode(pos) : 0;
+          m_next = { m_read_position, pos, cp };
+        }
+        return m_next;
+      }
+
+      // most arguments are ascii, those don't need a decode
+      code_point decode(size_t& pos) const
+      {
+        const auto byte = static_cast<uint8_t>(m_input[pos]);
+        if(byte < 0x80)
+        {
+          pos++;
+          return byte;
+        }
+        return utf8::decode(m_input, pos);
+      }
+
+      // the bytes of m_current as they are in the input
+      std::string_view current_char() const
+      {
+        return m_input.substr(m_position, m_read_position - m_position);
+      }
+
+     
+      token read_word()
+      {
+        const auto literal = read_identifire();
+        return { token_type::identifire, literal };
+      }
+
+      //all read_xxx functions return string_view because it's just reading from m_input and there is no need for another copy (other than in token)
+      std::string_view read_identifire()
+      {
+        size_t pos = m_position;
+        
+        //allow identifires to have number in them but not the first char like: foo_1 but not like: 1_foo (tricky to lex)
+        //an identifire ends at a space (not in an argv word), '=' or the end
+        const auto end = m_scanner.find(pos, m_args_mode ? &structural_scanner::masks::assign_end : &structural_scanner::masks::ident_end);
+        jump_to(end);
+        return m_input.substr(pos, end - pos);
+      }
+
+      std::string_view read_number()
+      {
+        size_t pos = m_position;
+        //TODO: add support for floats and sceintific notation and hex, oct, etc..
+        while(utf8::is_digit(m_current))
+        {
+          m_current = read_char();
+        }
+        return m_input.substr(pos, m_position - pos);
+      }
+
+      // double quoted strings can escape '"' and '\\' with a '\\' (like a posix shell)
+      // strings without escapes are views into m_input, the rest are unescaped into m_unescaped
+      std::string_view read_string(code_point open)
+      {
+        m_current = read_char(); //skip open
+        size_t pos = m_position; //after open 
+        bool escaped = false;
+        const auto stops = open == U'"' ? &structural_scanner::masks::dquote_end : &structural_scanner::masks::squote_end;
+        
+        for(size_t from = pos;;)
+        {
+          const auto end = m_scanner.find(from, stops);
+          jump_to(end);
+          if(m_current == U'\\')
+          {
+            //only '"' and '\\' can be escaped, the escaped char can't end the string
+            const auto next = end + 1 < m_input.size() ? m_input[end + 1] : '\0';
+            escaped = escaped || next == '"' || next == '\\';
+            from = end + (next == '"' || next == '\\' ? 2 : 1);
+            continue;
+          }
+          break; //the close, or '\0' //TODO: lex error unterminated string 
+        }
+
+        const auto raw = m_input.substr(pos, m_position - pos);
+        return escaped ? unescape(raw) : raw;
+      }
+
+      std::string_view unescape(std::string_view raw)
+      {
+        auto& buf = m_unescaped.emplace_back(std::make_unique<char[]>(raw.size()));
+        size_t size = 0;
+        for(size_t i = 0; i < raw.size(); i++)
+        {
+          if(raw[i] == '\\' && i + 1 < raw.size() && (raw[i + 1] == '"' || raw[i + 1] == '\\'))
+            i++;
+          buf[size++] = raw[i];
+        }
+        return { buf.get(), size };
+      }
+
+      void consume_whitespace()
+      {
+        if(m_args_mode)
+          return; // word boundaries are never redundant
+        //only redundent whitespace, the last space of a run is the space token
+        if(!m_classes.is(m_current, char_classes::space))
+          return;
+        const auto end = m_scanner.skip(m_position, &structural_scanner::masks::space);
+        if(end > m_position + 1)
+          jump_to(end - 1);
+      }
+
+      // makes the char at pos current (pos is always the start of a char)
+      void jump_to(size_t pos)
+      {
+        m_read_position = pos;
+        m_current = read_char();
+      }
+
+      // moves to the next argv word (if any), an empty one is lexed as an empty string
+      // returns true if it did, false otherwise (not in argv mode or no more words)
+      bool next_arg()
+      {
+        if(!m_args_mode)
+          return false;
+
+        while(m_arg_index < m_args.size() + m_words.size())
+        {
+          const auto i = m_arg_index++;
+          if(i < m_args.size() && m_args[i] == nullptr)
+            continue;
+          const input_type arg = i < m_args.size() ? input_type{ m_args[i] } : m_words[i - m_args.size()];
+
+          const auto depth = m_frames.size();
+          if(!arg.empty() && arg[0] == '@' && enter_response_file(arg, 0))
+          {
+            if(m_frames.size() == depth)
+              continue; // an empty file is like an empty word
+            return true;
           }
+
+          m_input = arg;
+          m_empty_word = arg.empty();
+          m_position = 0;
+          m_read_position = 0;
+          m_valid_utf8 = m_valid_utf8 && utf8::is_valid_utf8(m_input);
+          m_scanner.reset(m_input);
+          m_next = {};
+          return true;
+        }
+        return false;
+      }
+
+      // true if m_current is the first char of a word (line mode)
+      bool at_word_start() const
+      {
+        return m_position == 0 || m_classes.is(static_cast<uint8_t>(m_input[m_position - 1]), char_classes::space);
+      }
+
+      // an '@path' word is replaced by the contents of the file (GCC style response files), they are lexed like 
+      // a line (so they can name more of them) right from the mapping, resume is where to go on in the current 
+      // input once the file is done, returns false if word should be lexed as it is (not a file, or too deep)
+      // an empty file is expanded to nothing (true, but nothing is pushed)
+      bool enter_response_file(std::string_view word, size_t resume)
+      {
+        if(m_options.response_depth == 0 || word.size() < 2 || word[0] != '@')
+          return false;
+        if(m_depth_base + m_frames.size() >= m_options.response_depth)
+        {
+          m_too_deep.push_back(word);
+          return false;
+        }
+
+        const std::string path{ word.substr(1) };
+        auto file = mapped_file::open(path.c_str());
+        if(!file)
+          return false; // it's just an argument that starts with '@'
+
+        // without its leading and trailing spaces so the words around it get one space token each
+        auto content = file->view();
+        m_files.push_back(std::move(*file));
+        size_t begin = 0;
+        size_t end = content.size();
+        while(begin < end && m_classes.is(static_cast<uint8_t>(content[begin]), char_classes::space))
+          begin++;
+        while(end > begin && m_classes.is(static_cast<uint8_t>(content[end - 1]), char_classes::space))
+          end--;
+        if(begin == end)
+          return true;
+
+        m_frames.push_back({ m_input, resume, m_args_mode });
+        m_input = content.substr(begin, end - begin);
+        m_args_mode = false;
+        m_valid_utf8 = m_valid_utf8 && utf8::is_valid_utf8(m_input);
+        m_scanner.reset(m_input);
+        m_next = {};
+        m_position = 0;
+        m_read_position = 0;
+        if(is_big(m_input))
+        {
+          m_current = read_char();
+          lex_parallel();
+        }
+        return true;
+      }
+
+      // a line input worth lexing on many threads
+      bool is_big(input_type input) const
+      {
+        return !m_args_mode && m_options.threads != 1 && input.size() >= m_options.parallel_min_bytes;
+      }
+
+      // what a thread lexed of the current input starting at begin, up to the first token that starts at or after end
+      struct chunk
+      {
+        size_t begin{ 0 };
+        size_t end{ 0 };
+        std::vector<token> tokens;
+        std::vector<size_t> starts;  // where the lexer was before each token (npos in a nested response file)
+        size_t resume{ 0 };          // where the lexer got to
+        std::vector<std::pair<size_t, std::string_view>> too_deep; // by the index of the token they came with
+        size_t invalid_at{ npos };   // the first token of a nested file that wasn't valid utf-8
+      };
+
+      // the whole of the current (line) input lexed on m_options.threads threads into m_runs:
+      // it's split at whitespace that isn't in a string (going by the quote state at the split, each part's
+      // quote states are scanned on the threads first) and each chunk is lexed as if a token started there, 
+      // a chunk is only trusted from the first token the chunks before it actually got to (a string with a quote
+      // in an identifier before it or a token that crossed the split is lexed again up to there), so it's exactly
+      // what lexing it serially gives
+      void lex_parallel()
+      {
+        const auto input = m_input;
+        const size_t threads = m_options.threads == 0 ? std::max(1u, std::thread::hardware_concurrency()) : m_options.threads;
+        const size_t count = std::max<size_t>(1, std::min(threads * 4, input.size() / 4096));
+
+        // the quote state every part of the input ends in for each state it could start in, 
+        // then where each chunk starts
+        std::vector<quote_states> quotes(count);
+        parallel_for(count, threads, 1, [&](size_t, size_t first, size_t last) {
+          for(size_t c = first; c < last; c++)
+            quotes[c] = scan_quotes(input, input.size() * c / count, input.size() * (c + 1) / count);
+        });
+        std::vector<chunk> chunks(count);
+        quote_state state = quote_state::out;
+        for(size_t c = 0; c < count; c++)
+        {
+          chunks[c].begin = c == 0 ? 0 : split_point(input, input.size() * c / count, state);
+          state = quotes[c][static_cast<size_t>(state)];
+        }
+        for(size_t c = 0; c < count; c++)
+          chunks[c].end = c + 1 < count ? std::max(chunks[c].begin, chunks[c + 1].begin) : input.size();
+
+        std::vector<lexer> helpers(count);
+        parallel_for(count, threads, 1, [&](size_t, size_t first, size_t last) {
+          for(size_t c = first; c < last; c++)
+          {
+            helpers[c] = helper(chunks[c].begin);
+            helpers[c].lex_until(chunks[c]);
+          }
+        });
+
+        // stitch them in order (the tokens aren't copied, each chunk is a run from its first trusted token)
+        m_runs.clear();
+        m_run = 0;
+        size_t at = 0;
+        const auto take = [&](chunk& c, size_t from) {
+          for(const auto& [index, word] : c.too_deep)
+          {
+            if(index >= from)
+              m_too_deep.push_back(word);
+          }
+          m_valid_utf8 = m_valid_utf8 && (c.invalid_at == npos || c.invalid_at < from);
+          m_runs.push_back({ std::move(c.tokens), from });
+          at = c.resume;
+        };
+        take(chunks[0], 0);
+        for(size_t c = 1; c < count; c++)
+        {
+          auto& next = chunks[c];
+          if(at >= next.end)
+            continue; // all of it was in tokens of the chunks before
+          // (tokens of nested files have no start, they can't be synced to)
+          size_t k = 0;
+          while(k < next.starts.size() && (next.starts[k] == npos || next.starts[k] < at))
+            k++;
+          if(k < next.starts.size() && next.starts[k] == at)
+          {
+            take(next, k);
+            continue;
+          }
+
+          // lex from where the chunks before got to until it's at a token the chunk has
+          chunk fix;
+          fix.begin = at;
+          fix.end = next.end;
+          auto& lx = helpers.emplace_back(helper(at));
+          bool synced = false;
+          while(lx.m_frames.empty() ? lx.m_position < next.end : true)
+          {
+            if(lx.m_frames.empty())
+            {
+              while(k < next.starts.size() && (next.starts[k] == npos || next.starts[k] < lx.m_position))
+                k++;
+              if(k < next.starts.size() && next.starts[k] == lx.m_position)
+              {
+                synced = true;
+                break;
+              }
+            }
+            if(!lx.lex_one(fix))
+              break;
+          }
+          fix.resume = lx.m_position;
+          take(fix, 0);
+          if(synced)
+            take(next, k);
+        }
+
+        // the parts of helpers that tokens point into (unescaped strings, nested files) are kept
+        for(auto& lx : helpers)
+          m_helpers.push_back(std::move(lx));
+
+        // from here advance() hands out the runs, then goes on after the input
+        m_position = m_read_position = input.size();
+        m_current = 0;
+        m_next = {};
+      }
+
+      // a single threaded lexer of the current input at pos (a token start) with nothing to validate
+      lexer helper(size_t pos) const
+      {
+        lexer lx;
+        lx.m_input = m_input;
+        lx.m_delimiters = m_delimiters;
+        lx.m_classes = m_classes;
+        lx.m_options = m_options;
+        lx.m_options.threads = 1;
+        lx.m_depth_base = m_depth_base + m_frames.size();
+        lx.m_scanner.reset(m_input);
+        lx.jump_to(pos);
+        return lx;
+      }
+
+      // lexes c from c.begin, see chunk
+      void lex_until(chunk& c)
+      {
+        // ~6 bytes a token in most command lines, growing is what lexing into memory costs most
+        c.tokens.reserve((c.end - c.begin) / 6 + 16);
+        c.starts.reserve((c.end - c.begin) / 6 + 16);
+        while(!m_frames.empty() || m_position < c.end)
+        {
+          if(!lex_one(c))
+            break;
+        }
+        c.resume = m_position;
+      }
+
+      // one more token of c, false at the end of the input
+      bool lex_one(chunk& c)
+      {
+        const size_t at = m_frames.empty() ? m_position : npos;
+        const size_t deep = m_too_deep.size();
+        const bool valid = m_valid_utf8;
+        const auto tok = advance();
+        if(tok.type == token_type::eof)
+          return false;
+        if(m_too_deep.size() != deep)
+          c.too_deep.emplace_back(c.tokens.size(), m_too_deep.back());
+        if(valid && !m_valid_utf8)
+          c.invalid_at = c.tokens.size();
+        c.tokens.push_back(tok);
+        c.starts.push_back(at);
+        return true;
+      }
+
+      // where a split is in the quotes of a line: out of strings, in a '\'' or a '"' string or right after a '\\'
+      // in a '"' string (read_string's escapes, '\'' strings don't have any)
+      enum class quote_state : uint8_t
+      {
+        out, squote, dquote, dquote_escape
+      };
+
+      // indexed by the state a part of the input starts in
+      using quote_states = std::array<quote_state, 4>;
+
+      static constexpr quote_state next_quote_state(quote_state state, char c)
+      {
+        switch(state)
+        {
+          case quote_state::out:           return c == '\'' ? quote_state::squote : c == '"' ? quote_state::dquote : quote_state::out;
+          case quote_state::squote:        return c == '\'' ? quote_state::out : quote_state::squote;
+          case quote_state::dquote:        return c == '\\' ? quote_state::dquote_escape : c == '"' ? quote_state::out : quote_state::dquote;
+          case quote_state::dquote_escape: return quote_state::dquote;
+        }
+        return state;
+      }
+
+      // the state [begin, end) ends in for each state it can start in, all of them in one pass
+      static quote_states scan_quotes(input_type input, size_t begin, size_t end)
+      {
+        quote_states states{ quote_state::out, quote_state::squote, quote_state::dquote, quote_state::dquote_escape };
+        for(size_t i = begin; i < end; i++)
+        {
+          for(auto& state : states)
+            state = next_quote_state(state, input[i]);
+        }
+        return states;
+      }
+
+      // the first token start after whitespace (out of a string) at or after pos, state is the quote state at pos
+      size_t split_point(input_type input, size_t pos, quote_state state) const
+      {
+        for(; pos < input.size(); pos++)
+        {
+          const char c = input[pos];
+          if(state == quote_state::out && m_classes.is(static_cast<uint8_t>(c), char_classes::space))
+            break;
+          state = next_quote_state(state, c);
+        }
+        while(pos < input.size() && m_classes.is(static_cast<uint8_t>(input[pos]), char_classes::space))
+          pos++;
+        return pos;
+      }
+
+      // goes back to where the response file that just ended was named 
+      // returns false if there's nothing after it (in any of the inputs it's nested in)
+      bool leave_response_file()
+      {
+        while(!m_frames.empty())
+        {
+          const auto f = m_frames.back();
+          m_frames.pop_back();
+          m_input = f.input;
+          m_args_mode = f.args_mode;
+          m_scanner.reset(m_input);
+          m_next = {};
+          if(m_args_mode)
+          {
+            // the '@file' was a whole argv word
+            m_position = m_read_position = m_input.size();
+            if(next_arg())
+              return true;
+            continue;
+          }
+          // skip the spaces after the '@file', the end of the file was the space token
+          m_position = f.resume;
+          m_read_position = m_scanner.skip(f.resume, &structural_scanner::masks::space);
+          if(m_read_position < m_input.size())
+            return true;
+        }
+        return false;
+      }
+
+      // ch is the bytes of cp as they are in the input
+      bool is_delimiter(code_point cp, std::string_view ch) const
+      {
+        if(cp < 0x80)
+          return m_classes.is(cp, char_classes::delimiter);
+        return m_classes.has_wide_delimiters() && m_delimiters->find(ch) != m_delimiters->end();
+      }
+
+      static char_classes classes_of(const delimiter_set& ds)
+      {
+        static const char_classes defaults{ default_delimiters() };
+        return &ds == &default_delimiters() ? defaults : char_classes{ ds };
+      }
+    private:
+      input_type m_input;
+      size_t m_position{ 0 };
+      size_t m_read_position{ 0 };
+      code_point m_current{ 0 };
+      args_type m_args;
+      std::span<const std::string_view> m_words; // the args when they are views
+      size_t m_arg_index{ 0 };
+      bool m_args_mode{ false };
+      bool m_empty_word{ false }; // the current argv word is empty (its token is still to be lexed)
+      bool m_valid_utf8{ true };
+      const delimiter_set* m_delimiters{ &default_delimiters() };
+      char_classes m_classes{ classes_of(default_delimiters()) };
+      structural_scanner m_scanner;
+      lookahead m_next;
+      std::vector<std::unique_ptr<char[]>> m_unescaped; // storage of the tokens that needed unescaping
+
+      // an input that a response file interrupted
+      struct frame
+      {
+        input_type input;
+        size_t resume{ 0 };
+        bool args_mode{ false };
+      };
+
+      static constexpr size_t npos = static_cast<size_t>(-1);
+
+      lexer_options m_options;
+      size_t m_depth_base{ 0 }; // response files the input of a helper lexer is nested in
+      std::vector<frame> m_frames;
+      std::vector<mapped_file> m_files; // tokens of response files are views into these
+      std::vector<std::string_view> m_too_deep;
+      // the current input lexed by lex_parallel
+      struct run
+      {
+        std::vector<token> tokens;
+        size_t next{ 0 };
+      };
+      std::vector<run> m_runs;
+      size_t m_run{ 0 };
+      std::vector<lexer> m_helpers;
+    };
+
+    // a line lexer that is given the input a chunk at a time (e.g. as it's read from a pipe) so the line is 
+    // lexed while the rest of it is still coming, every byte is looked at once: the token a chunk ends in 
+    // (an identifier, a string, an escape, a run of spaces, a delimiter that may be a double one or a multi 
+    // byte char) is kept as a state that the next chunk goes on from, and utf-8 is validated up to the last 
+    // whole char of each chunk, it gives the tokens the lexer gives for the whole line ('@file' words aren't expanded)
+    class stream_lexer
+    {
+    public:
+      using delimiter_set = lexer::delimiter_set;
+    public:
+      // ds must outlive the stream_lexer
+      explicit stream_lexer(const delimiter_set& ds = lexer::default_delimiters())
+        : m_delimiters(&ds), m_classes(ds)
+      {
+      }
+
+      void feed(std::span<const char> chunk)
+      {
+        if(chunk.empty())
+          return;
+        m_text.append(chunk.data(), chunk.size());
+        validate(false);
+        m_scanner.reset(m_text);
+        lex(false);
+      }
+
+      // the end of the input ends the token it's in (like the end of a line does)
+      void finish()
+      {
+        validate(true);
+        m_scanner.reset(m_text);
+        lex(true);
+      }
+
+      // the tokens lexed so far, views into the stream_lexer until the next feed(), drop() or reset()
+      std::vector<token> tokens() const
+      {
+        std::vector<token> tokens;
+        tokens.reserve(m_pieces.size());
+        for(size_t i = 0; i < m_pieces.size(); i++)
+          tokens.push_back(at(i));
+        return tokens;
+      }
+
+      // the i-th token lexed so far (eof past the last one), a view like the ones of tokens()
+      token at(size_t i) const
+      {
+        using namespace std::string_view_literals;
+        if(i >= m_pieces.size())
+          return { token_type::eof, {} };
+        const auto& p = m_pieces[i];
+        if(p.type == token_type::space)
+          return { token_type::space, " "sv };
+        return { p.type, std::string_view{ p.unescaped ? m_unescaped : m_text }.substr(p.offset, p.size) };
+      }
+
+      // forgets the first count tokens (e.g. they were parsed) and the input only they were in, 
+      // the token that was count is at(0) after it
+      void drop(size_t count)
+      {
+        count = std::min(count, m_pieces.size());
+        m_pieces.erase(m_pieces.begin(), m_pieces.begin() + static_cast<std::ptrdiff_t>(count));
+
+        // the first byte anything still needs: a kept token, the token in progress or the char not validated yet
+        size_t text = std::min(m_state == state::start || m_state == state::done ? m_pos : m_begin, m_validated);
+        size_t unescaped = m_unescaped.size();
+        for(const auto& p : m_pieces)
+        {
+          if(p.unescaped)
+            unescaped = std::min(unescaped, p.offset);
+          else if(p.type != token_type::space)
+            text = std::min(text, p.offset);
+        }
+
+        for(auto& p : m_pieces)
+          p.offset -= p.unescaped ? unescaped : std::min(p.offset, text);
+        m_text.erase(0, text);
+        m_unescaped.erase(0, unescaped);
+        m_pos -= text;
+        m_begin -= std::min(m_begin, text);
+        m_validated -= text;
+        m_scanner.reset(m_text);
+      }
+
+      size_t token_count() const
+      {
+        return m_pieces.size();
+      }
+
+      // the bytes of the input that are kept (all of it unless drop() was called)
+      size_t buffered_size() const
+      {
+        return m_text.size() + m_unescaped.size();
+      }
+
+      // false if any of the input validated so far (all of it after finish()) wasn't valid utf-8
+      bool is_valid_utf8() const
+      {
+        return m_valid_utf8;
+      }
+
+      // for the next line (the buffers are kept)
+      void reset()
+      {
+        m_text.clear();
+        m_unescaped.clear();
+        m_pieces.clear();
+        m_scanner.reset({});
+        m_state = state::start;
+        m_pos = m_begin = m_validated = 0;
+        m_escaped = false;
+        m_valid_utf8 = true;
+      }
+    private:
+      enum class state : uint8_t
+      {
+        start, space, identifier, squote, dquote, dquote_escape, delimiter, done
+      };
+
+      // lexes from m_pos as far as the input goes, last ends the token in progress
+      void lex(bool last)
+      {
+        using masks = structural_scanner::masks;
+        const std::string_view text{ m_text };
+        while(true)
+        {
+          switch(m_state)
+          {
+            case state::start:
+            {
+              if(m_pos >= text.size())
+                return;
+              m_begin = m_pos;
+              const auto c = static_cast<uint8_t>(text[m_pos]);
+              if(c == 0)
+              {
+                m_state = state::done; // like the lexer, a '\0' is the end of the line
+                return;
+              }
+              if(m_classes.is(c, char_classes::space))
+              {
+                m_state = state::space;
+                m_pos++;
+              }
+              else if(c == '=')
+              {
+                m_pieces.push_back({ token_type::assign, m_pos, 1 });
+                m_pos++;
+              }
+              else if(c == '\'' || c == '"')
+              {
+                m_state = c == '"' ? state::dquote : state::squote;
+                m_escaped = false;
+                m_pos++;
+              }
+              else
+              {
+                size_t end = 0;
+                if(!char_end(m_pos, last, end))
+                  return;
+                m_state = is_delimiter(m_pos, end) ? state::delimiter : state::identifier;
+                m_pos = end;
+              }
+              break;
+            }
+            case state::space:
+            {
+              m_pos = m_scanner.skip(m_pos, &masks::space);
+              if(m_pos == text.size() && !last)
+                return;
+              m_pieces.push_back({ token_type::space, m_begin, 1 });
+              m_state = state::start;
+              break;
+            }
+            case state::identifier:
+            {
+              m_pos = m_scanner.find(m_pos, &masks::ident_end);
+              if(m_pos == text.size() && !last)
+                return;
+              m_pieces.push_back({ token_type::identifire, m_begin, m_pos - m_begin });
+              m_state = state::start;
+              break;
+            }
+            case state::squote:
+            {
+              m_pos = m_scanner.find(m_pos, &masks::squote_end);
+              if(m_pos == text.size())
+              {
+                if(!last)
+                  return;
+                save_string(m_begin + 1, m_pos); // unterminated, it's the rest of the line
+                m_state = state::start;
+                break;
+              }
+              save_string(m_begin + 1, m_pos);
+              m_pos++; // the close (or a '\0')
+              m_state = state::start;
+              break;
+            }
+            case state::dquote:
+            {
+              m_pos = m_scanner.find(m_pos, &masks::dquote_end);
+              if(m_pos == text.size())
+              {
+                if(!last)
+                  return;
+                save_string(m_begin + 1, m_pos);
+                m_state = state::start;
+                break;
+              }
+              if(text[m_pos] == '\\')
+              {
+                m_pos++;
+                m_state = state::dquote_escape;
+                break;
+              }
+              save_string(m_begin + 1, m_pos);
+              m_pos++;
+              m_state = state::start;
+              break;
+            }
+            case state::dquote_escape:
+            {
+              // only '"' and '\\' can be escaped, the escaped char can't end the string
+              if(m_pos == text.size())
+              {
+                if(!last)
+                  return;
+                save_string(m_begin + 1, m_pos);
+                m_state = state::start;
+                break;
+              }
+              if(text[m_pos] == '"' || text[m_pos] == '\\')
+              {
+                m_escaped = true;
+                m_pos++;
+              }
+              m_state = state::dquote;
+              break;
+            }
+            case state::delimiter:
+            {
+              // m_pos is after the first delimiter, a delimiter right after it makes a double one
+              size_t end = m_pos;
+              if(m_pos < text.size() && !char_end(m_pos, last, end))
+                return;
+              if(m_pos == text.size() && !last)
+                return;
+              const bool twice = m_pos < text.size() && is_delimiter(m_pos, end);
+              if(twice)
+                m_pos = end;
+              m_pieces.push_back({ twice ? token_type::double_delimiter : token_type::delimiter, m_begin, m_pos - m_begin });
+              m_state = state::start;
+              break;
+            }
+            case state::done:
+              return;
+          }
+        }
+      }
+
+      // the end of the char at pos (its first byte is enough unless it can be a wide delimiter),
+      // false if the rest of it is in the next chunk
+      bool char_end(size_t pos, bool last, size_t& end) const
+      {
+        const auto c = static_cast<uint8_t>(m_text[pos]);
+        size_t size = 1;
+        if(c >= 0x80 && m_classes.has_wide_delimiters())
+          size = std::max<size_t>(1, utf8::detail::get_sequence_length(c));
+        if(pos + size > m_text.size() && !last)
+          return false;
+        end = std::min(pos + size, m_text.size());
+        return true;
+      }
+
+      bool is_delimiter(size_t begin, size_t end) const
+      {
+        const auto c = static_cast<uint8_t>(m_text[begin]);
+        if(c < 0x80)
+          return m_classes.is(c, char_classes::delimiter);
+        return m_classes.has_wide_delimiters() 
+          && m_delimiters->find(std::string_view{ m_text }.substr(begin, end - begin)) != m_delimiters->end();
+      }
+
+      // strings with escapes are unescaped into m_unescaped (only '"' and '\\' are escaped)
+      void save_string(size_t begin, size_t end)
+      {
+        if(!m_escaped)
+        {
+          m_pieces.push_back({ token_type::string, begin, end - begin });
+          return;
+        }
+        const auto offset = m_unescaped.size();
+        for(size_t i = begin; i < end; i++)
+        {
+          if(m_text[i] == '\\' && i + 1 < end && (m_text[i + 1] == '"' || m_text[i + 1] == '\\'))
+            i++;
+          m_unescaped.push_back(m_text[i]);
+        }
+        m_pieces.push_back({ token_type::string, offset, m_unescaped.size() - offset, true });
+      }
+
+      // a char split over chunks is validated with the chunk that ends it
+      void validate(bool last)
+      {
+        size_t end = m_text.size();
+        for(size_t back = 1; !last && back <= 3 && back <= end - m_validated; back++)
+        {
+          const auto c = static_cast<uint8_t>(m_text[end - back]);
+          if((c & 0xC0) == 0x80)
+            continue;
+          if(utf8::detail::get_sequence_length(c) > back)
+            end -= back;
+          break;
+        }
+        m_valid_utf8 = m_valid_utf8 && utf8::is_valid_utf8(std::string_view{ m_text }.substr(m_validated, end - m_validated));
+        m_validated = end;
+      }
+    private:
+      // a token by its offset (tokens are made at the end, m_text moves as it grows)
+      struct piece
+      {
+        token_type type;
+        size_t offset{ 0 };
+        size_t size{ 0 };
+        bool unescaped{ false }; // in m_unescaped
+      };
+
+      const delimiter_set* m_delimiters;
+      char_classes m_classes;
+      structural_scanner m_scanner;
+      std::string m_text;
+      std::string m_unescaped;
+      std::vector<piece> m_pieces;
+      state m_state{ state::start };
+      size_t m_pos{ 0 };       // where lexing goes on
+      size_t m_begin{ 0 };     // of the token in progress
+      size_t m_validated{ 0 };
+      bool m_escaped{ false }; // the string in progress has escapes
+      bool m_valid_utf8{ true };
+    };
+
+    // all the tokens of an input lexed in one go, as columns (structure of arrays): the parser reads them by index 
+    // (any lookahead is an index) and lexing is a loop of its own instead of taking turns with parsing,
+    // a literal is where it starts (in whichever input or buffer of the lexer it's in) and its size, 
+    // so the lexer must outlive the array (values are 32 bit offsets anyway, see option::m_ends)
+    class token_array
+    {
+    public:
+      // lx to its end, the eof token is the last one
+      void lex(lexer& lx)
+      {
+        clear();
+        for(auto tok = lx.advance();; tok = lx.advance())
+        {
+          m_types.push_back(tok.type);
+          m_data.push_back(tok.literal.data());
+          m_sizes.push_back(static_cast<uint32_t>(tok.literal.size()));
+          if(tok.type == token_type::eof)
+            break;
+        }
+      }
+
+      // the eof token for any i past the end
+      token operator[](size_t i) const
+      {
+        i = std::min(i, m_types.size() - 1);
+        return { m_types[i], { m_data[i], m_sizes[i] } };
+      }
+
+      token_type type(size_t i) const
+      {
+        return m_types[std::min(i, m_types.size() - 1)];
+      }
+
+      // with the eof token
+      size_t size() const
+      {
+        return m_types.size();
+      }
+
+      // the columns are kept for the next input
+      void clear()
+      {
+        m_types.clear();
+        m_data.clear();
+        m_sizes.clear();
+      }
+    private:
+      std::vector<token_type> m_types;
+      std::vector<const char*> m_data;
+      std::vector<uint32_t> m_sizes;
+    };
+
+    // a line split into words the way a posix shell splits it (without expansions): words end at whitespace
+    // out of quotes, '...' is taken as it is, in "..." a '\\' escapes '"' '\\' '$' '`' and a newline, out of 
+    // quotes it escapes any char ('\\' newline is removed in both), and the parts of a word next to each other
+    // are one word (--name="a b" is the word --name=a b), the words are lexed as argv words after that
+    // unescaping is lazy: a word that's one part without escapes (abc or "a b") is a view into the line, 
+    // only the rest are unescaped (into the splitter, its buffer is kept between lines)
+    class shell_words
+    {
+    public:
+      // false if a quote wasn't closed (its word is the rest of the line)
+      // the words are views into line or the splitter until the next split()
+      bool split(std::string_view line)
+      {
+        m_words.clear();
+        m_storage.clear();
+        m_storage.reserve(line.size()); // a word is never longer unescaped so views into it don't move
+        bool closed = true;
+        size_t pos = 0;
+        while(true)
+        {
+          while(pos < line.size() && is_space(line[pos]))
+            pos++;
+          if(pos == line.size())
+            break;
+
+          const size_t begin = pos;
+          std::string_view part; // the last part of the word
+          size_t parts = 0;
+          bool escaped = false;
+          while(pos < line.size() && !is_space(line[pos]))
+          {
+            const char c = line[pos];
+            parts++;
+            if(c == '\'')
+            {
+              const auto close = line.find('\'', pos + 1);
+              closed = closed && close != npos;
+              const auto end = close == npos ? line.size() : close;
+              part = line.substr(pos + 1, end - pos - 1);
+              pos = close == npos ? end : end + 1;
+            }
+            else if(c == '"')
+            {
+              size_t end = pos + 1;
+              while(end < line.size() && line[end] != '"')
+              {
+                const bool escape = line[end] == '\\' && end + 1 < line.size() && is_dquote_escape(line[end + 1]);
+                escaped = escaped || escape;
+                end += escape ? 2 : 1;
+              }
+              closed = closed && end < line.size();
+              part = line.substr(pos + 1, end - pos - 1);
+              pos = end < line.size() ? end + 1 : end;
+            }
+            else if(c == '\\' && pos + 1 < line.size())
+            {
+              escaped = true;
+              pos += 2;
+            }
+            else
+            {
+              const size_t end = pos;
+              while(pos < line.size() && !is_space(line[pos]) && line[pos] != '\'' && line[pos] != '"' && (line[pos] != '\\' || pos + 1 == line.size()))
+                pos++;
+              part = line.substr(end, pos - end);
+            }
+          }
+
+          if(parts == 1 && !escaped)
+            m_words.push_back(part);
+          else
+            unescape(line.substr(begin, pos - begin));
+        }
+        return closed;
+      }
+
+      std::span<const std::string_view> words() const
+      {
+        return m_words;
+      }
+    private:
+      // the second look at a word that has to be put together (it's only these words)
+      void unescape(std::string_view word)
+      {
+        const auto offset = m_storage.size();
+        for(size_t i = 0; i < word.size(); i++)
+        {
+          const char c = word[i];
+          if(c == '\'')
+          {
+            const auto close = word.find('\'', i + 1);
+            const auto end = close == npos ? word.size() : close;
+            m_storage.append(word.substr(i + 1, end - i - 1));
+            i = end;
+          }
+          else if(c == '"')
+          {
+            for(i++; i < word.size() && word[i] != '"'; i++)
+            {
+              if(word[i] == '\\' && i + 1 < word.size() && is_dquote_escape(word[i + 1]))
+              {
+                if(word[++i] == '\n')
+                  continue;
+              }
+              m_storage.push_back(word[i]);
+            }
+          }
+          else if(c == '\\' && i + 1 < word.size())
+          {
+            if(word[++i] != '\n')
+              m_storage.push_back(word[i]);
+          }
+          else
+          {
+            m_storage.push_back(c);
+          }
+        }
+        m_words.push_back(std::string_view{ m_storage }.substr(offset));
+      }
+
+      static bool is_space(char c)
+      {
+        return c == ' ' || (c >= '\t' && c <= '\r');
+      }
+
+      static bool is_dquote_escape(char c)
+      {
+        return c == '"' || c == '\\' || c == '$' || c == '`' || c == '\n';
+      }
+    private:
+      static constexpr size_t npos = std::string_view::npos;
+
+      std::vector<std::string_view> m_words;
+      std::string m_storage;
+    };
+
+  } //namespace detail
+
+  namespace parse 
+  {
+    class option_builder;
+    
+    // conversions of raw values, nothing here allocates (but std::string) or throws
+    // integers are base 10 with an optional '+', the whole value has to be the number and in T's range
+    template <typename T> 
+    std::pair<T, bool> get(std::string_view value)
+    {
+      if constexpr(std::is_same_v<T, bool>)
+      {
+        // what people write for a boolean on the command line
+        if(value == "true" || value == "1" || value == "yes" || value == "on")
+          return { true, true };
+        if(value == "false" || value == "0" || value == "no" || value == "off")
+          return { false, true };
+        return { false, false };
+      }
+      else if constexpr(std::is_same_v<T, char>)
+      {
+        if(value.size() == 1)
+          return { value[0], true };
+        return { '\0', false };
+      }
+      else if constexpr(std::is_integral_v<T> || std::is_floating_point_v<T>)
+      {
+        // from_chars doesn't take a '+' (but a "+-1" is still not a number)
+        if(value.size() > 1 && value[0] == '+' && value[1] != '-')
+          value.remove_prefix(1);
+        T t{};
+        const auto [end, ec] = std::from_chars(value.data(), value.data() + value.size(), t);
+        if(ec != std::errc{} || end != value.data() + value.size())
+          return { T{}, false };
+        return { t, true };
+      }
+      else 
+      {
+        static_assert(sizeof(T) == 0, "no conversion for this type");
+      }
+    }
+
+    template <>
+    inline std::pair<std::string, bool> get(std::string_view value)
+    {
+      return { std::string{ value }, true };
+    }
+
+    template <>
+    inline std::pair<std::string_view, bool> get(std::string_view value)
+    {
+      return { value, true };
+    }
+
+    // converts values [first, last) of a list (see detail::nth_value, ends can't be empty) into out[first, last),
+    // vectorized for numbers, returns the index of the first value that doesn't convert (last if they all do)
+    template <typename T>
+    size_t convert_range(std::string_view raw, std::span<const uint32_t> ends, std::span<T> out, size_t first, size_t last)
+    {
+      const auto scalar = [&](size_t i) {
+        auto r = get<T>(detail::nth_value(raw, ends, i));
+        out[i] = std::move(r.first);
+        return r.second;
+      };
+
+      if constexpr((std::is_integral_v<T> || std::is_floating_point_v<T>) && !std::is_same_v<T, bool> && !std::is_same_v<T, char>)
+      {
+        constexpr size_t chunk_size = 256;
+        const auto kernel = detail::decimal_parser::best_parser();
+        detail::decimal chunk[chunk_size];
+        for(size_t i = first; i < last;)
+        {
+          const size_t end = std::min(last, i + chunk_size);
+          const size_t stop = kernel(raw, ends.data(), i, end, chunk);
+          for(size_t j = i; j < stop; j++)
+          {
+            if(!detail::from_decimal(chunk[j - i], out[j]) && !scalar(j))
+              return j;
+          }
+          i = stop;
+          if(i < end)
+          {
+            if(!scalar(i))
+              return i;
+            i++;
+          }
+        }
+      }
+      else
+      {
+        for(size_t i = first; i < last; i++)
+        {
+          if(!scalar(i))
+            return i;
+        }
+      }
+      return last;
+    }
+
+    // lists with fewer values than this are converted on the calling thread whatever the thread count is
+    inline constexpr size_t parallel_list_threshold = 1 << 16;
+
+    // converts the values of a list into out, as many as fit, on 'threads' threads (0 is one per core) if the list 
+    // is long enough, each value is written to its own index so the output doesn't depend on how it was split
+    // returns how many were written or the index of the first value that doesn't convert 
+    // (the lowest failing index, the same for any number of threads)
+    template <typename T>
+    std::expected<size_t, size_t> convert_list(std::string_view raw, std::span<const uint32_t> ends, std::span<T> out, size_t threads = 1)
+    {
+      const uint32_t whole[1] = { static_cast<uint32_t>(raw.size()) };
+      if(ends.empty())
+      {
+        if(raw.empty())
+          return 0;
+        ends = whole;
+      }
+      const size_t n = std::min(ends.size(), out.size());
+      if(threads == 0)
+        threads = std::max(1u, std::thread::hardware_concurrency());
+
+      if(threads == 1 || n < parallel_list_threshold)
+      {
+        const size_t stop = convert_range(raw, ends, out, 0, n);
+        if(stop != n)
+          return std::unexpected(stop);
+        return n;
+      }
+
+      // chunks past a failing index are skipped, they can't lower it
+      constexpr size_t chunk = 1 << 14;
+      std::atomic<size_t> first_error{ n };
+      detail::parallel_for(n, threads, chunk, [&](size_t, size_t begin, size_t end) {
+        if(begin >= first_error.load(std::memory_order_relaxed))
+          return;
+        const size_t stop = convert_range(raw, ends, out, begin, end);
+        if(stop == end)
+          return;
+        size_t seen = first_error.load(std::memory_order_relaxed);
+        while(stop < seen && !first_error.compare_exchange_weak(seen, stop, std::memory_order_relaxed))
+        {
+        }
+      });
+      if(first_error != n)
+        return std::unexpected(first_error.load());
+      return n;
+    }
+
+    class command_builder;
+
+    // stable indexes of what a command declares, given out when it's added, they address the command's
+    // resault directly (an array index, no hashing), a handle only means something to the command it came from
+    struct option_handle
+    {
+      uint32_t index{ 0 };
+    };
+
+    struct flag_handle
+    {
+      uint32_t index{ 0 };
+    };
+
+    struct command_handle
+    {
+      uint32_t index{ 0 };
+    };
+
+    // the value of a typed option, converted once when it's parsed (untyped options only have their raw value)
+    using typed_value = std::variant<std::monostate, int64_t, uint64_t, double, bool>;
+
+    // where a parsed value is written as it's parsed: a variable or a member of the object given to the session
+    // write returns false if the value doesn't convert to the bound type
+    struct binding
+    {
+      std::function<bool(void* object, std::string_view raw, const typed_value& value)> write;
+      const std::type_info* object_type{ nullptr }; // the class of a member binding
+
+      explicit operator bool() const
+      {
+        return static_cast<bool>(write);
+      }
+
+      // an option given without a value sets a bool, the converted value is used when it's of T
+      template <typename T>
+      static bool assign(T& target, std::string_view raw, const typed_value& value)
+      {
+        static_assert(!std::is_same_v<T, std::string_view>, "bind a std::string, a view would dangle once the session resets");
+        if constexpr(std::is_same_v<T, bool>)
+        {
+          if(raw.empty() && std::holds_alternative<std::monostate>(value))
+          {
+            target = true;
+            return true;
+          }
+        }
+        if constexpr(std::is_same_v<T, int64_t> || std::is_same_v<T, uint64_t> || std::is_same_v<T, double> || std::is_same_v<T, bool>)
+        {
+          if(const auto* v = std::get_if<T>(&value))
+          {
+            target = *v;
+            return true;
+          }
+        }
+        auto r = get<T>(raw);
+        if(r.second)
+          target = std::move(r.first);
+        return r.second;
+      }
+
+      template <typename T>
+      static binding to(T& variable)
+      {
+        return { [p = &variable](void*, std::string_view raw, const typed_value& value) { return assign(*p, raw, value); } };
+      }
+
+      template <typename C, typename T>
+      static binding to(T C::* member)
+      {
+        return { [member](void* object, std::string_view raw, const typed_value& value) { 
+          return assign(static_cast<C*>(object)->*member, raw, value); 
+        }, &typeid(C) };
+      }
+    };
+
+    class option_builder
+    {
+    public:
+      using default_value_type = std::string;
+      enum class alias_options
+      {
+        off, single_delimiter, double_delimiter, //TODO: (or maybe not) as_name
+        _default = single_delimiter
+      };
+
+      // what .as<T>() declared, raw options are converted on every get<T>()
+      enum class value_type : uint8_t
+      {
+        raw, string, int64, uint64, floating, boolean
+      };
+    public:
+      // these change the parent's schema so they are defined after command_builder
+      option_builder& requires_value(); // e.g. g++ -o a.out
+
+      option_builder& allow_multiple();
+
+      option_builder& set_alias(const std::string& name); //via the parent
+
+      option_builder& set_alias_options(alias_options opts);
+
+      // the value is converted to T when it's parsed, a value that doesn't convert is a diagnostic
+      // T is one of int64_t, uint64_t, double, bool, std::string_view or std::string (implies requires_value)
+      template <typename T>
+      option_builder& as()
+      {
+        m_type = value_type_of<T>();
+        return requires_value();
+      }
+
+      // the value the option has when it's not on the command line (as it would be written on it)
+      option_builder& default_value(std::string_view raw);
+
+      // the value the option has when it's given without one, a value then has to be
+      // attached with an '=' (e.g. --color is --color=always, --color=never still works)
+      option_builder& implicit_value(std::string_view raw);
+
+      template <typename T> requires std::is_arithmetic_v<T>
+      option_builder& default_value(T value)
+      {
+        return default_value(std::string_view{ format(value) });
+      }
+
+      template <typename T> requires std::is_arithmetic_v<T>
+      option_builder& implicit_value(T value)
+      {
+        return implicit_value(std::string_view{ format(value) });
+      }
+
+      // the value is written to variable as it's parsed (the option isn't added to the resault)
+      // variable must outlive the parses, binding anything but a bool implies requires_value
+      template <typename T>
+      option_builder& bind(T& variable)
+      {
+        return bind(binding::to(variable), std::is_same_v<T, bool>);
+      }
+
+      // same as above but into a member of the object given to parse_session::bind_object()
+      // (or parser::parse_into()), e.g. bind(&config::threads)
+      template <typename C, typename T>
+      option_builder& bind(T C::* member)
+      {
+        return bind(binding::to(member), std::is_same_v<T, bool>);
+      }
+
+      option_handle handle() const
+      {
+        return { m_index };
+      }
+
+      operator option_handle() const
+      {
+        return handle();
+      }
+
+      // what .as<T>() declares
+      template <typename T>
+      static constexpr value_type value_type_of()
+      {
+        if constexpr(std::is_same_v<T, int64_t>)
+          return value_type::int64;
+        else if constexpr(std::is_same_v<T, uint64_t>)
+          return value_type::uint64;
+        else if constexpr(std::is_same_v<T, double>)
+          return value_type::floating;
+        else if constexpr(std::is_same_v<T, bool>)
+          return value_type::boolean;
+        else if constexpr(std::is_same_v<T, std::string_view> || std::is_same_v<T, std::string>)
+          return value_type::string;
+        else
+          static_assert(sizeof(T) == 0, "options can be int64_t, uint64_t, double, bool or strings");
+      }
+
+      option_builder() = default;
+    private:
+      option_builder(command_builder* parent, const std::string& name, uint32_t index)
+        : m_index(index), m_parent(parent), m_name(name)
+      {
+      }
+
+      option_builder& bind(binding&& b, bool is_bool);
+
+      // the raw form of a typed default
+      template <typename T>
+      static std::string format(T value)
+      {
+        if constexpr(std::is_same_v<T, bool>)
+        {
+          return value ? "true" : "false";
+        }
+        else
+        {
+          char buf[64];
+          const auto [end, ec] = std::to_chars(buf, buf + sizeof(buf), value);
+          return { buf, end };
+        }
+      }
+    private:
+      bool m_requires_value{ false };
+      bool m_allows_multiple{ false };
+      alias_options m_alias_opts{ alias_options::_default };
+      value_type m_type{ value_type::raw };
+      std::optional<std::string> m_default;
+      std::optional<std::string> m_implicit;
+      binding m_bind;
+      uint32_t m_index{ 0 }; // the handle, the order it was added in
+      command_builder* m_parent{ nullptr };
+      std::string m_name;
+    private:
+      friend class parser;
+      friend class parse_session;
+      friend class command_builder;
+      friend class schema;
+    };
+
+
+    class command_builder 
+    {
+    public:
+      using default_value_type = std::string;
+    public:
+      
+      //new one for the added command
+      // the builders convert to their handles (command_handle h = add_subcommand("x");),
+      // adding a name again gives the same handle
+      command_builder& add_subcommand(const std::string& name) // e.g. git submodule
+      {
+        const auto index = static_cast<uint32_t>(m_subcommands.size());
+        auto [it, added] = m_subcommands.try_emplace(name);
+        auto& sub = it->second;
+        if(added)
+          sub.m_index = index;
+        sub.m_debug_name = name; // debug only
+        sub.m_generation = m_generation;
+        touch();
+        return sub;
+      }
+
+      option_builder& add_option(const std::string& name) // e.g. git --version
+      {
+        const auto index = static_cast<uint32_t>(m_options.size());
+        auto [it, added] = m_options.try_emplace(name);
+        auto& opt = it->second;
+        opt = option_builder{ this, name, added ? index : opt.m_index };
+        touch();
+        return opt;
+      }
+
+      flag_handle add_flag(const std::string& name) // must be one utf-8 char 
+                                                    // e.g git -v
+      {
+        const auto [it, added] = m_flags.try_emplace(name, static_cast<uint32_t>(m_flags.size()));
+        touch();
+        return { it->second };
+      }
+
+      // this command in its parent
+      command_handle handle() const
+      {
+        return { m_index };
+      }
+
+      operator command_handle() const
+      {
+        return handle();
+      }
+
+      command_builder& requires_value() // e.g. git submodule add <url> <path> 
+                                        // this could require a value of type string array
+      {
+        m_requires_value = true;
+        touch();
+        return *this;
+      }
+
+      command_builder& allows_multiple()
+      {
+        m_allows_multiple = true;
+        touch();
+        return *this;
+      }
+
+      command_builder& set_option_alias(const std::string& alias_name, const std::string& option_name) //TODO: clash resulotion config
+      {
+        m_options_aliases[alias_name] = option_name;
+        touch();
+        return *this;
+      }
+
+      // set to true when the (sub)command is on the command line, used must outlive the parses
+      command_builder& bind(bool& used)
+      {
+        m_bind = binding::to(used);
+        touch();
+        return *this;
+      }
+
+      // same as above but into a member of the object given to parse_session::bind_object()
+      template <typename C>
+      command_builder& bind(bool C::* used)
+      {
+        m_bind = binding::to(used);
+        touch();
+        return *this;
+      }
+    public://private:
+      command_builder() = default;
+    private:
+      // any change to the tree makes the parser's frozen tables stale
+      void touch()
+      {
+        if(m_generation)
+          ++*m_generation;
+      }
+
+      // a copied (or moved) tree counts its own changes and its options point to their new commands
+      void adopt(const std::shared_ptr<uint64_t>& generation)
+      {
+        m_generation = generation;
+        for(auto& [_, opt] : m_options)
+          opt.m_parent = this;
+        for(auto& [_, sub] : m_subcommands)
+          sub.adopt(generation);
+      }
+    private:
+      std::string m_debug_name;
+      detail::string_map<command_builder> m_subcommands;
+      detail::string_map<option_builder> m_options;
+      detail::string_map<uint32_t> m_flags; // { flag : handle }
+      detail::string_map<std::string> m_options_aliases;// { alias : option } 
+      bool m_requires_value{ false };
+      bool m_allows_multiple{ false };
+      binding m_bind;
+      uint32_t m_index{ 0 }; // the handle in the parent
+      std::shared_ptr<uint64_t> m_generation; // shared by the whole tree (set by the parser)
+    private:
+      friend class parser;
+      friend class parse_session;
+      friend class option_builder;
+      friend class schema;
+    };
+ 
+    inline option_builder& option_builder::requires_value()
+    {
+      m_requires_value = true;
+      if(m_parent)
+        m_parent->touch();
+      return *this;
+    }
+
+    inline option_builder& option_builder::allow_multiple()
+    {
+      m_allows_multiple = true;
+      if(m_parent)
+        m_parent->touch();
+      return *this;
+    }
+
+    inline option_builder& option_builder::set_alias(const std::string& name)
+    {
+      m_parent->set_option_alias(name, m_name);
+      return *this;
+    }
+
+    inline option_builder& option_builder::set_alias_options(alias_options opts)
+    {
+      m_alias_opts = opts;
+      if(m_parent)
+        m_parent->touch();
+      return *this;
+    }
+
+    inline option_builder& option_builder::bind(binding&& b, bool is_bool)
+    {
+      m_bind = std::move(b);
+      if(!is_bool)
+        m_requires_value = true;
+      if(m_parent)
+        m_parent->touch();
+      return *this;
+    }
+
+    inline option_builder& option_builder::default_value(std::string_view raw)
+    {
+      m_default = std::string{ raw };
+      if(m_parent)
+        m_parent->touch();
+      return *this;
+    }
+
+    inline option_builder& option_builder::implicit_value(std::string_view raw)
+    {
+      m_implicit = std::string{ raw };
+      if(m_parent)
+        m_parent->touch();
+      return *this;
+    }
+
+    // converts raw to type into value, raw and string options have nothing to convert
+    inline bool convert(option_builder::value_type type, std::string_view raw, typed_value& value)
+    {
+      using value_type = option_builder::value_type;
+      const auto store = [&](auto r) {
+        if(r.second)
+          value = r.first;
+        return r.second;
+      };
+      switch(type)
+      {
+        case value_type::int64:    return store(get<int64_t>(raw));
+        case value_type::uint64:   return store(get<uint64_t>(raw));
+        case value_type::floating: return store(get<double>(raw));
+        case value_type::boolean:  return store(get<bool>(raw));
+        default:                   return true;
+      }
+    }
+
+    // a default or implicit value of an option, converted once when the schema is built
+    struct preset_value
+    {
+      std::string_view raw;
+      typed_value value;
+      bool valid{ true }; // false if raw doesn't convert to the option's type (reported when it's used)
+    };
+
+    // the frozen form of an option_builder, it's a constant (a static_option's is made at compile time)
+    struct option_spec
+    {
+      std::string_view name;
+      bool requires_value{ false };
+      bool allows_multiple{ false };
+      option_builder::alias_options alias_opts{ option_builder::alias_options::_default };
+      option_builder::value_type type{ option_builder::value_type::raw };
+    };
+
+    // the rest of an option_builder, what a static_option doesn't have (so it isn't in option_spec)
+    struct option_extras
+    {
+      std::optional<preset_value> default_value;
+      std::optional<preset_value> implicit_value;
+      binding bound; // written instead of added to the resault
+    };
+
+    // the frozen form of a command_builder, all the names the command knows
+    // (options, aliases, flags and subcommands) are in one symbol table,
+    // the arrays are views, of the static ones of a static_command or of the command's own storage 
+    // (like symbol_table's), the presets and the bindings are a side table that a static command doesn't have
+    struct command_spec
+    {
+      // what a compiled command's views are of
+      struct storage
+      {
+        std::vector<option_spec> options;
+        std::vector<option_extras> extras;
+        std::vector<std::string_view> flags;
+        std::vector<uint32_t> subcommands;
+        binding bound;
+      };
+
+      std::string_view name;
+      bool requires_value{ false };
+      bool allows_multiple{ false };
+      bool has_defaults{ false };              // some option has a default_value
+      const binding* bound{ nullptr };
+      std::span<const option_spec> options;    // indexed by option_handle
+      std::span<const option_extras> extras;   // indexed by option_handle, empty if no option has any
+      std::span<const std::string_view> flags; // indexed by flag_handle
+      detail::flag_chars flag_chars;           // the one char flags, for clusters (-xzvf)
+      std::span<const uint32_t> subcommands;   // the schema's index of each command_handle
+      detail::symbol_table symbols;
+      std::unique_ptr<const storage> owned;    // null if the arrays are static
+    };
+
+    // the compile time form of a command_spec, everything is in static storage: the names, the specs
+    // and the slots and seeds of the command's symbol table (built at compile time)
+    struct static_command_spec
+    {
+      std::string_view name;
+      bool requires_value{ false };
+      bool allows_multiple{ false };
+      std::span<const option_spec> options;        // indexed by option_handle
+      std::span<const std::string_view> flags;     // indexed by flag_handle
+      std::span<const uint32_t> subcommands;       // the schema's index of each command_handle
+      std::span<const detail::symbol> slots;
+      std::span<const uint32_t> seeds;
+      uint64_t salt{ 0 };
+      size_t symbol_count{ 0 };
+    };
+
+    // the immutable compiled form of a parser, it owns all of its names (it doesn't point into the builders)
+    // so it can outlive and ignore later changes to the parser, nothing in it changes after construction
+    // so any number of threads can parse against one schema without locks (each with its own parse_session)
+    class schema 
+    {
+    public:
+      explicit schema(const command_builder& root, const detail::lexer_options& lexing = {})
+        : m_lexing(lexing)
+      {
+        compile(root, {});
+      }
+
+      // the commands of a static_parser (the root first), nothing is copied, interned or hashed:
+      // the names, the specs and the symbol tables are views of the static ones
+      explicit schema(std::span<const static_command_spec> commands, const detail::lexer_options& lexing = {})
+        : m_lexing(lexing)
+      {
+        m_commands.resize(commands.size());
+        for(size_t i = 0; i < commands.size(); i++)
+        {
+          const auto& cmd = commands[i];
+          auto& spec = m_commands[i];
+          spec.name = cmd.name;
+          spec.requires_value = cmd.requires_value;
+          spec.allows_multiple = cmd.allows_multiple;
+          spec.options = cmd.options;
+          spec.flags = cmd.flags;
+          spec.flag_chars = detail::flag_chars{ cmd.flags };
+          spec.subcommands = cmd.subcommands;
+          spec.symbols = detail::symbol_table{ cmd.slots, cmd.seeds, cmd.salt, cmd.symbol_count };
+        }
+      }
+
+      schema(const schema&) = delete;
+      schema& operator=(const schema&) = delete;
+
+      const command_spec& root() const
+      {
+        return m_commands.front();
+      }
+
+      // indexed by symbol::subcommand_index, the root is the first one
+      std::span<const command_spec> commands() const
+      {
+        return m_commands;
+      }
+
+      // response files and threads of the lexers that parse against this
+      const detail::lexer_options& lexing() const
+      {
+        return m_lexing;
+      }
+    private:
+      std::string_view intern(std::string_view name)
+      {
+        if(name.empty())
+          return {};
+        auto* p = static_cast<char*>(m_names.allocate(name.size(), 1));
+        std::memcpy(p, name.data(), name.size());
+        return { p, name.size() };
+      }
+
+      std::optional<preset_value> preset(const option_builder& opt_build, const std::optional<std::string>& raw)
+      {
+        if(!raw)
+          return std::nullopt;
+        preset_value pv{ intern(*raw), typed_value{}, true };
+        pv.valid = opt_build.m_allows_multiple || convert(opt_build.m_type, pv.raw, pv.value);
+        return pv;
+      }
+
+      uint32_t compile(const command_builder& cmd_build, std::string_view name)
+      {
+        const auto index = static_cast<uint32_t>(m_commands.size());
+        m_commands.emplace_back();
+
+        command_spec spec;
+        auto owned = std::make_unique<command_spec::storage>();
+        spec.name = intern(name);
+        spec.requires_value = cmd_build.m_requires_value;
+        spec.allows_multiple = cmd_build.m_allows_multiple;
+        owned->bound = cmd_build.m_bind;
+
+        std::unordered_map<std::string_view, detail::symbol> symbols;
+        auto add = [&](std::string_view sym_name, detail::symbol::kind k) -> detail::symbol& {
+          auto& sym = symbols[sym_name];
+          if(sym.name.empty())
+            sym.name = intern(sym_name);
+          sym.kinds |= k;
+          return sym;
+        };
+
+        // everything is placed at its handle
+        owned->options.resize(cmd_build.m_options.size());
+        owned->extras.resize(cmd_build.m_options.size());
+        bool has_extras = false;
+        for(const auto& [opt_name, opt_build] : cmd_build.m_options)
+        {
+          auto& sym = add(opt_name, detail::symbol::option);
+          sym.option_index = opt_build.m_index;
+          owned->options[opt_build.m_index] = option_spec{ .name = sym.name, .requires_value = opt_build.m_requires_value, 
+                                                           .allows_multiple = opt_build.m_allows_multiple, 
+                                                           .alias_opts = opt_build.m_alias_opts, .type = opt_build.m_type };
+          auto& extras = owned->extras[opt_build.m_index];
+          extras.default_value = preset(opt_build, opt_build.m_default);
+          extras.implicit_value = preset(opt_build, opt_build.m_implicit);
+          extras.bound = opt_build.m_bind;
+          has_extras = has_extras || extras.default_value || extras.implicit_value || extras.bound;
+          spec.has_defaults = spec.has_defaults || opt_build.m_default.has_value();
+        }
+        if(!has_extras)
+          owned->extras.clear();
+
+        for(const auto& [alias_name, opt_name] : cmd_build.m_options_aliases)
+        {
+          const auto opt_it = symbols.find(opt_name);
+          if(symbols.end() == opt_it || !opt_it->second.is(detail::symbol::option))
+            continue; // alias of an option that doesn't exist
+
+          const auto opt_index = opt_it->second.option_index;
+          add(alias_name, detail::symbol::alias).alias_index = opt_index;
+        }
+
+        owned->flags.resize(cmd_build.m_flags.size());
+        for(const auto& [flag_name, flag_index] : cmd_build.m_flags)
+        {
+          auto& sym = add(flag_name, detail::symbol::flag);
+          sym.flag_index = flag_index;
+          owned->flags[flag_index] = sym.name;
+        }
+        spec.flag_chars = detail::flag_chars{ owned->flags };
+
+        owned->subcommands.resize(cmd_build.m_subcommands.size());
+        for(const auto& [sub_name, sub_build] : cmd_build.m_subcommands)
+        {
+          const auto sub_index = compile(sub_build, sub_name);
+          auto& sym = add(sub_name, detail::symbol::subcommand);
+          sym.subcommand_index = sub_index;
+          sym.child_index = sub_build.m_index;
+          owned->subcommands[sub_build.m_index] = sub_index;
+        }
+
+        std::vector<detail::symbol> entries;
+        entries.reserve(symbols.size());
+        for(const auto& [_, sym] : symbols)
+          entries.push_back(sym);
+        spec.symbols = detail::symbol_table{ entries };
+
+        spec.bound = owned->bound ? &owned->bound : nullptr;
+        spec.options = owned->options;
+        spec.extras = owned->extras;
+        spec.flags = owned->flags;
+        spec.subcommands = owned->subcommands;
+        spec.owned = std::move(owned);
+        m_commands[index] = std::move(spec);
+        return index;
+      }
+    private:
+      // every name of the schema, from the heap (not the default resource of when it was frozen, a schema outlives that)
+      std::pmr::monotonic_buffer_resource m_names{ std::pmr::new_delete_resource() };
+      std::vector<command_spec> m_commands;
+      detail::lexer_options m_lexing;
+    };
+
+
+    /*
+    class hashable 
+    {
+    public:
+      hashable() = default;
+      hashable(std::string_view name)
+        : m_name(name)
+      {
+      }
+
+      const std::string& get_name() const
+      {
+        return m_name;
+      }
+
+      bool operator == (const hashable& h)
+      {
+        return m_name == h.m_name;
+      }
+    protected:
+      std::string m_name;
+    };
+
+    struct hashable_hash
+    {
+      size_t operator()(const hashable& hb)
+      {
+        return std::hash<std::string>{}(hb.get_name());
+      }
+    };
+    */
+
+
+    // for now options that allows multiple values are final by that i mean you can't use any other option after an option that requires a value.
+    // i don't know if this is what it supposed to be or there is another way around but i didn't see any program that do otherwise
+    // the other way around is forcing syntax like: 
+    // multiple(arrays): --opt = [val1, val2, val3] (or) --opt = [val1 val2 val3] with or without an equals sign
+    // maps: --opt = { key1 : value1, key2 : value2 } (or) --opt = { ke1 : value1 key2: value2 } with or without an equal sign
+    // this forces keys on maps to don't have space in them or you can use a string literal to do so or we can remove the none comma version
+    // maybe allow both and if usage is without brackets assume final otherwise don't (best of both worlds) i guess
+    class option //: public hashable
+    {
+    public:
+      using allocator_type = std::pmr::polymorphic_allocator<>;
+
+      enum class state 
+      {
+        not_convertable, no_value
+      };
+    public:
+      bool has_value() const
+      {
+        return !m_value.empty();
+      }
+
+      const std::pmr::string& get_raw() const
+      {
+        return m_value;
+      }
+
+      // a typed option (.as<T>()) that is asked for its own type just loads the converted value
+      template <typename T>
+      std::expected<T, state> get() const
+      {
+        if constexpr(std::is_same_v<T, int64_t> || std::is_same_v<T, uint64_t> || std::is_same_v<T, double> || std::is_same_v<T, bool>)
+        {
+          if(const auto* v = std::get_if<T>(&m_typed))
+            return *v;
+        }
+        if(!m_value.empty())
+        {
+          auto r = parse::get<T>(std::string_view{ m_value });
+          if(r.second)
+            return r.first;
+          
+          return std::unexpected(state::not_convertable);
+        }
+        return std::unexpected(state::no_value);
+      }
+
+      // true if the option wasn't on the command line and has its default_value
+      bool is_default() const
+      {
+        return m_defaulted;
+      }
+      
+      // the values of a multi valued option (one value for the others), a lazy random access range 
+      // of views into the option, reading them doesn't allocate
+      auto values() const
+      {
+        return std::views::iota(size_t{ 0 }, value_count()) 
+             | std::views::transform([this](size_t i) { return detail::nth_value(m_value, m_ends, i); });
+      }
+
+      // values() converted to T as they are read (each is an std::expected<T, state>)
+      template <typename T>
+      auto values_as() const
+      {
+        return values() | std::views::transform([](std::string_view v) -> std::expected<T, state> {
+          auto r = parse::get<T>(v);
+          if(r.second)
+            return std::move(r.first);
+          return std::unexpected(state::not_convertable);
+        });
+      }
+
+      size_t value_count() const
+      {
+        return m_ends.empty() ? !m_value.empty() : m_ends.size();
+      }
+
+      //allow both '--opt [opt1, opt2, opt3]' and '--opt opt1 opt2 opt3'
+      template <typename T>
+      std::expected<std::vector<T>, state> get_vector(size_t threads = 1) const
+      {
+        if(m_value.empty())
+          return std::unexpected(state::no_value);
+        
+        std::vector<T> vec;
+        if constexpr(std::is_arithmetic_v<T> && !std::is_same_v<T, bool>)
+        {
+          // numbers go through the bulk conversion (threads only matter for long lists)
+          vec.resize(value_count());
+          if(!parse::convert_list<T>(m_value, m_ends, std::span<T>{ vec }, threads))
+            return std::unexpected(state::not_convertable);
+        }
+        else
+        {
+          vec.reserve(value_count());
+          for(auto v : values_as<T>())
+          {
+            if(!v)
+              return std::unexpected(v.error());
+            vec.emplace_back(std::move(*v));
+          }
+        }
+        return vec;
+      }
+
+      // every value converted at once into out (as many as fit), numbers are split by the vector kernels
+      // and long lists are converted on 'threads' threads (0 is one per core, see convert_list),
+      // returns the written part of out or the index of the first value that doesn't convert
+      template <typename T>
+      std::expected<std::span<T>, size_t> get_list(std::span<T> out, size_t threads = 1) const
+      {
+        const auto r = parse::convert_list<T>(m_value, m_ends, out, threads);
+        if(!r)
+          return std::unexpected(r.error());
+        return out.first(*r);
+      }
+
+      // same but in the resault's memory (freed with it)
+      template <typename T>
+      std::expected<std::pmr::vector<T>, size_t> get_list(size_t threads = 1) const
+      {
+        static_assert(!std::is_same_v<T, bool>, "a vector<bool> has no span, use values_as<bool>()");
+        std::pmr::vector<T> vec(value_count(), m_value.get_allocator());
+        const auto r = parse::convert_list<T>(m_value, m_ends, std::span<T>{ vec }, threads);
+        if(!r)
+          return std::unexpected(r.error());
+        return vec;
+      }
+
+      //TODO: maybe requires map, and usage would be: --opt { key1:value1 key1:value1 }
+      //bool operator == (const option& opt) const
+      //{
+      //  return m_name == opt.m_name;
+      //}
+    //private:
+      option() = default;
+
+      // allocator aware so options in a result live in the result's memory resource
+      explicit option(const allocator_type& alloc)
+        : m_value(alloc), m_ends(alloc)
+      {
+      }
+
+      option(const option& other, const allocator_type& alloc)
+        : m_value(other.m_value, alloc), m_ends(other.m_ends, alloc), m_typed(other.m_typed), m_defaulted(other.m_defaulted)
+      {
+      }
+
+      option(option&& other, const allocator_type& alloc)
+        : m_value(std::move(other.m_value), alloc), m_ends(std::move(other.m_ends), alloc), m_typed(other.m_typed), 
+          m_defaulted(other.m_defaulted)
+      {
+      }
+
+      option(const option&) = default;
+      option(option&&) = default;
+      option& operator=(const option&) = default;
+      option& operator=(option&&) = default;
+
+      //option(std::string_view name, std::string_view val = "")
+      //  : m_name(name), m_value(val)
+      //{
+      //}
+    private:
+      //std::string m_name;
+      std::pmr::string m_value;        // the values separated by spaces
+      std::pmr::vector<uint32_t> m_ends; // where each value ends in m_value (multi valued options only)
+      typed_value m_typed;
+      bool m_defaulted{ false };
+    private:
+      friend class parser;
+      friend class parse_session;
+    };
+
+    
+    // idon't know if flags should allow values or not like: 'g++ -std=c++23'
+    // this don't make sense in our implementation because:
+    // -1: -std would translate to -s -t -d 
+    // -2: flags don't have values either called or not
+    // unless aliases would override the default parse behavior
+    // only then '-std=c++23' would translate to something like: ' --standard_version=c++23 ' 
+    // this is what i'll implement but i have no idea how to do so efficiently
+    class flag //: public hashable
+    {
+    public:
+      //bool operator == (const flag& f) const
+      //{
+      //  return m_name == f.m_name;
+      //}
+    private:
+      //std::string m_name;
+    public://private:
+      flag() = default;
+      //explicit flag(std::string_view name, bool val = false)
+      //  : m_name(name), m_value(val)
+      //{
+      //}
+    private:
+      friend class parser;
+      friend class parse_session;
+    };
+
+    class command //: public hashable
+    {
+    public:
+      using allocator_type = std::pmr::polymorphic_allocator<>;
+
+      enum class state 
+      {
+        not_found, not_convertable, no_value
+      };
+    public: 
+      bool has_value() const 
+      {
+        return !m_value.empty();
+      }
+
+      const std::pmr::string& get_raw() const
+      {
+        return m_value;
+      }
+
+      template <typename T>
+      std::expected<T, state> get() const
+      {
+        if(!m_value.empty())
+        {
+          auto r = parse::get<T>(std::string_view{ m_value });
+          if(r.second)
+            return r.first;
+
+          return std::unexpected(state::not_convertable);
+        } 
+        return std::unexpected(state::no_value);
+      }
+      
+      // same as option::values(), the values of a subcommand that allows multiple ones
+      auto values() const
+      {
+        return std::views::iota(size_t{ 0 }, value_count()) 
+             | std::views::transform([this](size_t i) { return detail::nth_value(m_value, m_ends, i); });
+      }
+
+      template <typename T>
+      auto values_as() const
+      {
+        return values() | std::views::transform([](std::string_view v) -> std::expected<T, state> {
+          auto r = parse::get<T>(v);
+          if(r.second)
+            return std::move(r.first);
+          return std::unexpected(state::not_convertable);
+        });
+      }
+
+      size_t value_count() const
+      {
+        return m_ends.empty() ? !m_value.empty() : m_ends.size();
+      }
+
+      // allow both '--opt [opt1, opt2, opt3]' and '--opt opt1 opt2 opt3'
+      template <typename T>
+      std::expected<std::vector<T>, state> get_vector(size_t threads = 1) const
+      {
+        if(m_value.empty())
+          return std::unexpected(state::no_value);
+
+        std::vector<T> vec;
+        if constexpr(std::is_arithmetic_v<T> && !std::is_same_v<T, bool>)
+        {
+          // numbers go through the bulk conversion (threads only matter for long lists)
+          vec.resize(value_count());
+          if(!parse::convert_list<T>(m_value, m_ends, std::span<T>{ vec }, threads))
+            return std::unexpected(state::not_convertable);
+        }
+        else
+        {
+          vec.reserve(value_count());
+          for(auto v : values_as<T>())
+          {
+            if(!v)
+              return std::unexpected(v.error());
+            vec.emplace_back(std::move(*v));
+          }
+        }
+        return vec;
+      }
+
+      // by handle: an index and a bit test
+      std::expected<std::reference_wrapper<command>, state> get_command(command_handle h)
+      {
+        if(!present(command_bit(h.index)))
+          return std::unexpected(state::not_found);
+        return std::ref(m_commands[h.index]);
+      }
+
+      std::expected<std::reference_wrapper<option>, state> get_option(option_handle h)
+      {
+        if(!present(option_bit(h.index)))
+          return std::unexpected(state::not_found);
+        return std::ref(m_options[h.index]);
+      }
+
+      std::expected<std::reference_wrapper<const command>, state> get_command(command_handle h) const
+      {
+        if(!present(command_bit(h.index)))
+          return std::unexpected(state::not_found);
+        return std::cref(m_commands[h.index]);
+      }
+
+      std::expected<std::reference_wrapper<const option>, state> get_option(option_handle h) const
+      {
+        if(!present(option_bit(h.index)))
+          return std::unexpected(state::not_found);
+        return std::cref(m_options[h.index]);
+      }
+
+      std::expected<flag, state> get_flag(flag_handle h) const
+      {
+        if(!present(flag_bit(h.index)))
+          return std::unexpected(state::not_found);
+        return flag{};
+      }
+
+      bool has_flag(flag_handle h) const
+      {
+        return present(flag_bit(h.index));
+      }
+
+      // by name (for convenience): one lookup in the command's symbol table then the same as above
+      std::expected<std::reference_wrapper<command>, state> get_command(std::string_view name)
+      {
+        if(const auto* sym = find(name, detail::symbol::subcommand))
+          return get_command(command_handle{ sym->child_index });
+        return std::unexpected(state::not_found);
+      }
+
+      std::expected<std::reference_wrapper<option>, state> get_option(std::string_view name)
+      {
+        if(const auto* sym = find(name, detail::symbol::option))
+          return get_option(option_handle{ sym->option_index });
+        return std::unexpected(state::not_found);
+      }
+
+      std::expected<std::reference_wrapper<const command>, state> get_command(std::string_view name) const
+      {
+        if(const auto* sym = find(name, detail::symbol::subcommand))
+          return get_command(command_handle{ sym->child_index });
+        return std::unexpected(state::not_found);
+      }
+
+      std::expected<std::reference_wrapper<const option>, state> get_option(std::string_view name) const
+      {
+        if(const auto* sym = find(name, detail::symbol::option))
+          return get_option(option_handle{ sym->option_index });
+        return std::unexpected(state::not_found);
+      }
+
+      std::expected<flag, state> get_flag(std::string_view name) const
+      {
+        if(const auto* sym = find(name, detail::symbol::flag))
+          return get_flag(flag_handle{ sym->flag_index });
+        return std::unexpected(state::not_found);
+      }
+
+      // the (name, value) pairs of what's present, in handle order
+      template <typename T>
+      class entries
+      {
+      public:
+        class iterator
+        {
+        public:
+          std::pair<std::string_view, const T&> operator*() const
+          {
+            return m_owner->entry(m_index, static_cast<const T*>(nullptr));
+          }
+
+          iterator& operator++()
+          {
+            m_index = m_owner->next(m_index + 1, static_cast<const T*>(nullptr));
+            return *this;
+          }
+
+          bool operator==(const iterator&) const = default;
+        private:
+          iterator(const command* owner, size_t index)
+            : m_owner(owner), m_index(index)
+          {
+          }
+        private:
+          const command* m_owner;
+          size_t m_index;
+        private:
+          friend class entries;
+        };
+      public:
+        iterator begin() const
+        {
+          return { m_owner, m_owner->next(0, static_cast<const T*>(nullptr)) };
+        }
+
+        iterator end() const
+        {
+          return { m_owner, m_owner->count(static_cast<const T*>(nullptr)) };
+        }
+      private:
+        explicit entries(const command* owner)
+          : m_owner(owner)
+        {
+        }
+      private:
+        const command* m_owner;
+      private:
+        friend class command;
+      };
+
+      entries<command> get_subcommands() const
+      {
+        return entries<command>{ this };
+      }
+
+      entries<option> get_options() const 
+      {
+        return entries<option>{ this };
+      } 
+
+      entries<flag> get_flags() const 
+      {
+        return entries<flag>{ this };
+      }
+
+      allocator_type get_allocator() const
+      {
+        return m_bits.get_allocator();
+      }
+
+      //bool operator == (const command& cmd) const
+      //{
+      //  return m_name == cmd.m_name;
+      //}
+    //private:
+      command() = default;
+
+      // allocator aware so a whole result tree lives in the result's memory resource
+      explicit command(const allocator_type& alloc)
+        : m_value(alloc), m_ends(alloc), m_options(alloc), m_commands(alloc), m_bits(alloc)
+      {
+      }
+
+      command(const command& other, const allocator_type& alloc)
+        : m_value(other.m_value, alloc), m_ends(other.m_ends, alloc), m_spec(other.m_spec), m_options(other.m_options, alloc), 
+          m_commands(other.m_commands, alloc), m_bits(other.m_bits, alloc)
+      {
+      }
+
+      command(command&& other, const allocator_type& alloc)
+        : m_value(std::move(other.m_value), alloc), m_ends(std::move(other.m_ends), alloc), m_spec(other.m_spec), 
+          m_options(std::move(other.m_options), alloc), m_commands(std::move(other.m_commands), alloc), m_bits(std::move(other.m_bits), alloc)
+      {
+      }
+
+      command(const command&) = default;
+      command(command&&) = default;
+      command& operator=(const command&) = default;
+      command& operator=(command&&) = default;
+      //explicit command(std::string_view name, std::string_view val = "")
+      //  : m_name(name), m_value(val)
+      //{ 
+      //}
+    private:
+      // sized for spec (everything absent), the presence bits are laid out as flags, options then subcommands
+      void init(const command_spec& spec)
+      {
+        m_spec = &spec;
+        m_value.clear();
+        m_ends.clear();
+        m_options.clear();
+        m_options.resize(spec.options.size());
+        m_commands.clear();
+        m_commands.resize(spec.subcommands.size());
+        m_bits.assign((spec.flags.size() + spec.options.size() + spec.subcommands.size() + 63) / 64, 0);
+      }
+
+      const detail::symbol* find(std::string_view name, detail::symbol::kind k) const
+      {
+        if(!m_spec)
+          return nullptr;
+        const auto* sym = m_spec->symbols.find(name);
+        return sym && sym->is(k) ? sym : nullptr;
+      }
+
+      size_t flag_bit(size_t i) const
+      {
+        return i;
+      }
+
+      size_t option_bit(size_t i) const
+      {
+        return m_spec->flags.size() + i;
+      }
+
+      size_t command_bit(size_t i) const
+      {
+        return m_spec->flags.size() + m_spec->options.size() + i;
+      }
+
+      bool present(size_t bit) const
+      {
+        return bit / 64 < m_bits.size() && (m_bits[bit / 64] >> (bit % 64) & 1) != 0;
+      }
+
+      void set_present(size_t bit)
+      {
+        m_bits[bit / 64] |= uint64_t{ 1 } << (bit % 64);
+      }
+
+      // the first present T at or after i (the count of T if none)
+      template <typename T>
+      size_t next(size_t i, const T* kind) const
+      {
+        if(!m_spec)
+          return 0;
+        const auto n = count(kind);
+        const auto base = first_bit(kind);
+        while(i < n)
+        {
+          const auto bit = base + i;
+          const auto word = m_bits[bit / 64] >> (bit % 64);
+          if(word != 0)
+            return std::min(n, i + std::countr_zero(word));
+          i += 64 - bit % 64;
+        }
+        return n;
+      }
+
+      size_t count(const flag*) const    { return m_spec ? m_spec->flags.size() : 0; }
+      size_t count(const option*) const  { return m_spec ? m_spec->options.size() : 0; }
+      size_t count(const command*) const { return m_spec ? m_spec->subcommands.size() : 0; }
+
+      size_t first_bit(const flag*) const    { return flag_bit(0); }
+      size_t first_bit(const option*) const  { return option_bit(0); }
+      size_t first_bit(const command*) const { return command_bit(0); }
+
+      std::pair<std::string_view, const flag&> entry(size_t i, const flag*) const
+      {
+        static const flag f;
+        return { m_spec->flags[i], f };
+      }
+
+      std::pair<std::string_view, const option&> entry(size_t i, const option*) const
+      {
+        return { m_spec->options[i].name, m_options[i] };
+      }
+
+      std::pair<std::string_view, const command&> entry(size_t i, const command*) const
+      {
+        return { m_commands[i].m_spec->name, m_commands[i] };
+      }
+    private:
+      //std::string m_name;
+      std::pmr::string m_value;
+      std::pmr::vector<uint32_t> m_ends;         // where each value ends in m_value (see option)
+      const command_spec* m_spec{ nullptr };     // what this command can have (the resault keeps the schema alive)
+      std::pmr::vector<option> m_options;        // indexed by option_handle
+      std::pmr::vector<command> m_commands;      // indexed by command_handle
+      std::pmr::vector<uint64_t> m_bits;         // presence of every flag, option and subcommand
+    private:
+      friend class parser;
+      friend class parse_session;
+      friend class parse_resault;
+    };
+
+    // something in the input the parser couldn't make sense of
+    struct diagnostic 
+    {
+      enum class kind : uint8_t
+      {
+        unknown,       // not an option, alias, flag or subcommand of the current command
+        missing_value, // an option or a subcommand that requires a value didn't get one
+        invalid_utf8,  // the input isn't valid utf-8 (it's still parsed, bad sequences read as '?')
+        invalid_value, // the value (or the default) of a typed option doesn't convert to its type
+        response_file, // an '@file' nested deeper than the parser's response_files() limit (it's parsed as it is)
+        unterminated_quote // a quote of a shell_words() line wasn't closed (its word is the rest of the line)
+      };
+
+      kind type{ kind::unknown };
+      std::pmr::string token; // the identifier (without delimiters) or the option/subcommand name
+    };
+
+    class parse_resault 
+    {
+    public:
+      using allocator_type = std::pmr::polymorphic_allocator<>;
+    public:
+      parse_resault() = default;
+      explicit parse_resault(const allocator_type& alloc)
+        : root(alloc), errors(alloc)
+      {
+      }
+
+      parse_resault(parse_resault&& other, const allocator_type& alloc)
+        : root(std::move(other.root), alloc), errors(std::move(other.errors), alloc), m_schema(std::move(other.m_schema))
+      {
+      }
+
+      parse_resault(const parse_resault&) = default;
+      parse_resault(parse_resault&&) = default;
+      parse_resault& operator=(const parse_resault&) = default;
+      parse_resault& operator=(parse_resault&&) = default;
+
+      bool has_error() const
+      {
+        return !errors.empty();
+      }
+    public:
+      command root;
+      std::pmr::vector<diagnostic> errors; // in input order
+    private:
+      std::shared_ptr<const schema> m_schema; // the specs the commands point to
+    private:
+      friend class parse_session;
+    };
+
+    class parse_session;
+
+    // told about everything as it's parsed (parse_session::visit), in argv order and without a resault being built:
+    // handles are of the command the last on_command was for (the root before any), names are the schema's and 
+    // values are views that are only valid in the call, a list's values are separated by a space and ends has 
+    // where each one ends (empty for a single value), defaults aren't told (they are in the schema)
+    class parse_visitor
+    {
+    public:
+      virtual ~parse_visitor() = default;
+
+      virtual void on_command(command_handle, std::string_view /*name*/, std::string_view /*value*/, std::span<const uint32_t> /*ends*/) {}
+      virtual void on_option(option_handle, std::string_view /*name*/, std::string_view /*value*/, std::span<const uint32_t> /*ends*/) {}
+      virtual void on_flag(flag_handle, std::string_view /*name*/) {}
+      // a word that isn't an option, a flag or a subcommand of the current command (a resault has it as unknown)
+      virtual void on_positional(std::string_view /*word*/) {}
+      virtual void on_diagnostic(diagnostic::kind, std::string_view /*token*/) {}
+    };
+
+    // one call of a parse_visitor, parse_session::events() is the parse as a range of them
+    struct parse_event
+    {
+      enum class kind : uint8_t
+      {
+        command, option, flag, positional, diagnostic
+      };
+
+      kind type{ kind::positional };
+      uint32_t id{ 0 };              // the index of the handle, or the diagnostic::kind
+      std::string_view name;         // (the token of a diagnostic is the value)
+      std::string_view value;
+      std::span<const uint32_t> ends;
+    };
+
+    class parser 
+    {
+    public: 
+      parser()
+      {
+        m_root.m_generation = std::make_shared<uint64_t>(0);
+      }
+
+      // a copy has its own builders (and its own schema)
+      parser(const parser& other)
+        : m_root(other.m_root), m_lexing(other.m_lexing)
+      {
+        m_root.adopt(std::make_shared<uint64_t>(0));
+      }
+
+      parser& operator=(const parser& other)
+      {
+        std::lock_guard lock{ m_schema_mutex };
+        m_root = other.m_root;
+        m_root.adopt(std::make_shared<uint64_t>(0));
+        m_lexing = other.m_lexing;
+        m_schema.reset();
+        m_schema_generation = 0;
+        return *this;
+      }
+
+      parser(parser&& other)
+        : m_root(std::move(other.m_root)), m_lexing(other.m_lexing), m_schema(std::move(other.m_schema)), 
+          m_schema_generation(other.m_schema_generation)
+      {
+        m_root.adopt(m_root.m_generation);
+      }
+
+      parser& operator=(parser&& other)
+      {
+        std::lock_guard lock{ m_schema_mutex };
+        m_root = std::move(other.m_root);
+        m_root.adopt(m_root.m_generation);
+        m_lexing = other.m_lexing;
+        m_schema = std::move(other.m_schema);
+        m_schema_generation = other.m_schema_generation;
+        return *this;
+      }
+      
+      // build stage(pre parse)
+      
+      inline command_builder& add_subcommand(const std::string& name)
+      {
+        return m_root.add_subcommand(name);
+      }
+      
+      inline option_builder& add_option(const std::string& name)
+      {
+        return m_root.add_option(name);
+      }
+
+      inline flag_handle add_flag(const std::string& name)
+      {
+        return m_root.add_flag(name);
+      }
+
+      // expands '@path' arguments to the arguments in the file (whitespace separated, quoted like a line),
+      // files can name more files up to max_depth deep, an '@' word that isn't a readable file stays as it is
+      // 0 turns it off (the default)
+      parser& response_files(size_t max_depth = 8)
+      {
+        m_lexing.response_depth = max_depth;
+        m_root.touch();
+        return *this;
+      }
+
+      // lexes line inputs (parse(line), response files) of at least min_bytes on 'threads' threads (0 is one per core),
+      // the tokens are the same as lexing them on one thread
+      parser& parallel_lexing(size_t threads = 0, size_t min_bytes = 1 << 20)
+      {
+        m_lexing.threads = threads;
+        m_lexing.parallel_min_bytes = min_bytes;
+        m_root.touch();
+        return *this;
+      }
+
+      // lines (parse(line)) are split into words like a posix shell splits them: quotes and '\\' escapes are
+      // removed, the parts of a word next to each other are one word ('--name="a b"' is one), then the words are
+      // parsed as argv words (so a line parses like the argv a shell makes of it)
+      parser& shell_words(bool on = true)
+      {
+        m_lexing.shell_words = on;
+        m_root.touch();
+        return *this;
+      }
+
+      // the whole input is lexed before it's parsed (into a detail::token_array that the session keeps),
+      // lexing is then one loop of its own, worth it for long inputs
+      parser& token_array(bool on = true)
+      {
+        m_lexing.token_array = on;
+        m_root.touch();
+        return *this;
+      }
+
+      // parse function(only one function)
+      // TODO: windowsss(not utf-8)
+      // the resault is self contained (heap allocated), use a parse_session to parse 
+      // many command lines against the same parser without allocating each resault
+      parse_resault parse(int argc, char** argv) const;
+
+      // args must not contain the launch command name
+      parse_resault parse(std::span<char* const> args) const;
+
+      // one command line in a string, see shell_words()
+      parse_resault parse(std::string_view line) const;
+
+      // parse(argc, argv) with the member bindings writing into object
+      template <typename C>
+      parse_resault parse_into(C& object, int argc, char** argv) const;
+
+      // compiles every command into a command_spec with one perfect hash table for all of its names
+      // the schema is compiled once and shared until the parser changes, share it between threads 
+      // (a parse_session per thread) instead of building a parser per thread
+      // parse() freezes on demand so calling this is only needed to pay the cost up front
+      std::shared_ptr<const schema> freeze() const
+      {
+        std::lock_guard lock{ m_schema_mutex };
+        if(!m_schema || m_schema_generation != generation())
+        {
+          m_schema = std::make_shared<const schema>(m_root, m_lexing);
+          m_schema_generation = generation();
+        }
+        return m_schema;
+      }
+
+      bool is_frozen() const
+      {
+        std::lock_guard lock{ m_schema_mutex };
+        return m_schema && m_schema_generation == generation();
+      }
+    private:
+      uint64_t generation() const
+      {
+        return m_root.m_generation ? *m_root.m_generation : 0;
+      }
+    private:
+      command_builder m_root; // root command (doesn't allow any value) update: why not?!
+                              // this would be the interface that builds the whole application
+      detail::lexer_options m_lexing;
+      mutable std::mutex m_schema_mutex;
+      mutable std::shared_ptr<const schema> m_schema;
+      mutable uint64_t m_schema_generation{ 0 };
+    };
+
+    // all the state of one parse, it shares the (immutable) schema so one session per thread
+    // can parse against the same schema, sessions are cache line aligned so they don't false share
+    // resaults are allocated from the session's arena and handed out by move,
+    // they stay valid until reset() (or until the session dies) so call reset() 
+    // once you are done with them, reset() is O(1) (it just rewinds the arena)
+    class alignas(detail::cache_line_size) parse_session 
+    {
+    public:
+      static constexpr size_t default_arena_size = 16 * 1024;
+    public:
+      explicit parse_session(std::shared_ptr<const schema> sc, size_t arena_size = default_arena_size)
+        : m_schema(std::move(sc)), m_buffer_size(arena_size == 0 ? default_arena_size : arena_size)
+      {
+        m_buffer = std::make_unique_for_overwrite<std::byte[]>(m_buffer_size);
+        m_arena.emplace(m_buffer.get(), m_buffer_size, &m_upstream);
+        m_resource = &*m_arena;
+      }
+
+      // resaults (and what a visit reads its values into) are allocated from resource (not from an arena) 
+      // and reset() does nothing
+      parse_session(std::shared_ptr<const schema> sc, std::pmr::memory_resource* resource)
+        : m_schema(std::move(sc)), m_resource(resource), m_scratch(resource), m_scratch_ends(resource)
+      {
+      }
+
+      // parses against the parser's schema as it is now (later changes to the parser aren't seen)
+      explicit parse_session(const parser& p, size_t arena_size = default_arena_size)
+        : parse_session(p.freeze(), arena_size)
+      {
+      }
+
+      parse_session(const parser& p, std::pmr::memory_resource* resource)
+        : parse_session(p.freeze(), resource)
+      {
+      }
+
+      parse_session(const parse_session&) = delete;
+      parse_session& operator=(const parse_session&) = delete;
+
+      parse_resault parse(int argc, char** argv)
+      {
+        // no need for launch command name
+        if(argc > 1)
+          return parse(std::span<char* const>(argv + 1, static_cast<size_t>(argc - 1)));
+        return parse(std::span<char* const>{});
+      }
+
+      // args must not contain the launch command name
+      parse_resault parse(std::span<char* const> args)
+      {
+        parse_resault pr{ m_resource };
+        // each argument is lexed in place (no joining), so arguments can have spaces in them
+        begin(pr, detail::lexer{ args, detail::lexer::default_delimiters(), m_schema->lexing() });
+        run();
+        return pr;
+      }
+
+      // one command line in a string (e.g. a line of a log), it's split into arguments by the lexer
+      // (or like a shell splits it, see parser::shell_words())
+      parse_resault parse(std::string_view line)
+      {
+        parse_resault pr{ m_resource };
+        parse_line(pr, line);
+        return pr;
+      }
+
+      // the same parses without a resault, v is told about everything as it's parsed (see parse_visitor)
+      void visit(std::span<char* const> args, parse_visitor& v)
+      {
+        parse_resault pr{ m_resource };
+        m_visitor = &v;
+        begin(pr, detail::lexer{ args, detail::lexer::default_delimiters(), m_schema->lexing() });
+        run();
+        m_visitor = nullptr;
+      }
+
+      void visit(std::string_view line, parse_visitor& v)
+      {
+        parse_resault pr{ m_resource };
+        m_visitor = &v;
+        parse_line(pr, line);
+        m_visitor = nullptr;
+      }
+
+      // the events of visit() as a range, they stay valid until the next events() (the buffers are reused so
+      // once they're big enough nothing is allocated)
+      std::span<const parse_event> events(std::span<char* const> args)
+      {
+        m_recorder.clear();
+        visit(args, m_recorder);
+        return m_recorder.events();
+      }
+
+      std::span<const parse_event> events(std::string_view line)
+      {
+        m_recorder.clear();
+        visit(line, m_recorder);
+        return m_recorder.events();
+      }
+
+      // a command line that comes a chunk at a time (e.g. read from a pipe), the chunks can be split anywhere,
+      // each is lexed as it's fed (see detail::stream_lexer) and parsed as far as it's sure to parse the same 
+      // with the rest of the line (see can_step()), the parsed input is dropped so only the rest of it is kept,
+      // until finish() the session is busy with the fed line (it can't parse or visit anything else)
+      void feed(std::span<const char> chunk)
+      {
+        m_stream.feed(chunk);
+        if(!m_fed)
+          begin_stream();
+        resume();
+      }
+
+      // so a string literal isn't fed with its '\0'
+      void feed(const char* chunk)
+      {
+        feed(std::string_view{ chunk });
+      }
+
+      // the bytes of the fed line that are kept, the ones feed() couldn't parse yet
+      size_t buffered_size() const
+      {
+        return m_stream.buffered_size();
+      }
+
+      // parses the rest of what was fed since the last finish()
+      parse_resault finish()
+      {
+        m_stream.finish();
+        if(!m_fed)
+          begin_stream();
+        refresh();
+        run();
+        m_streaming = false;
+        m_stream.reset(); // the values were copied into the resault
+        parse_resault pr{ std::move(*m_fed) };
+        m_fed.reset();
+        return pr;
+      }
+
+      // the pull side of feed(): chunks is any range of chunks of one line (e.g. a std::generator that reads a pipe)
+      template <std::ranges::input_range R>
+        requires std::convertible_to<std::ranges::range_reference_t<R>, std::span<const char>>
+      parse_resault parse_chunks(R&& chunks)
+      {
+        for(auto&& chunk : chunks)
+          feed(std::span<const char>(chunk));
+        return finish();
+      }
+
+      // frees every resault of this session at once,
+      // if the arena had to grow past its buffer the buffer grows so the next parses fit in it
+      void reset()
+      {
+        if(!m_arena)
+          return;
+
+        const auto grown = m_upstream.allocated();
+        m_arena->release();
+        if(grown > 0)
+        {
+          m_arena.reset();
+          m_buffer_size += grown;
+          m_buffer = std::make_unique_for_overwrite<std::byte[]>(m_buffer_size);
+          m_arena.emplace(m_buffer.get(), m_buffer_size, &m_upstream);
+        }
+        m_upstream.reset_count();
+      }
+
+      std::pmr::memory_resource* resource() const
+      {
+        return m_resource;
+      }
+
+      // member bindings (bind(&C::member)) of the following parses write into object,
+      // it must outlive them
+      template <typename C>
+      void bind_object(C& object)
+      {
+        m_object = &object;
+        m_object_type = &typeid(C);
+      }
+
+      size_t arena_size() const
+      {
+        return m_buffer_size;
+      }
+    private:
+      // records the calls of a visit() for events()
+      class recorder final : public parse_visitor
+      {
+      public:
+        void clear()
+        {
+          m_events.clear();
+          m_places.clear();
+          m_text.clear();
+          m_ends.clear();
+        }
+
+        // the views are made at the end (the buffers move as they grow)
+        std::span<const parse_event> events()
+        {
+          const std::string_view text{ m_text };
+          const std::span<const uint32_t> ends{ m_ends };
+          for(size_t i = 0; i < m_events.size(); i++)
+          {
+            const auto& p = m_places[i];
+            m_events[i].value = text.substr(p.text, p.text_size);
+            m_events[i].ends = ends.subspan(p.ends, p.ends_size);
+          }
+          return m_events;
+        }
+
+        void on_command(command_handle h, std::string_view name, std::string_view value, std::span<const uint32_t> ends) override
+        {
+          add(parse_event::kind::command, h.index, name, value, ends);
+        }
+
+        void on_option(option_handle h, std::string_view name, std::string_view value, std::span<const uint32_t> ends) override
+        {
+          add(parse_event::kind::option, h.index, name, value, ends);
+        }
+
+        void on_flag(flag_handle h, std::string_view name) override
+        {
+          add(parse_event::kind::flag, h.index, name, {}, {});
+        }
+
+        void on_positional(std::string_view word) override
+        {
+          add(parse_event::kind::positional, 0, {}, word, {});
+        }
+
+        void on_diagnostic(diagnostic::kind type, std::string_view token) override
+        {
+          add(parse_event::kind::diagnostic, static_cast<uint32_t>(type), {}, token, {});
+        }
+      private:
+        void add(parse_event::kind type, uint32_t id, std::string_view name, std::string_view value, std::span<const uint32_t> ends)
+        {
+          m_events.push_back({ type, id, name, {}, {} });
+          m_places.push_back({ m_text.size(), value.size(), m_ends.size(), ends.size() });
+          m_text += value;
+          m_ends.insert(m_ends.end(), ends.begin(), ends.end());
+        }
+      private:
+        struct place
+        {
+          size_t text, text_size, ends, ends_size;
+        };
+
+        std::vector<parse_event> m_events;
+        std::vector<place> m_places;
+        std::string m_text; // the values (names are views into the schema)
+        std::vector<uint32_t> m_ends;
+      };
+
+      void parse_line(parse_resault& pr, std::string_view line)
+      {
+        if(m_schema->lexing().shell_words)
+        {
+          const bool closed = m_words.split(line);
+          begin(pr, detail::lexer{ m_words.words(), detail::lexer::default_delimiters(), m_schema->lexing() });
+          run();
+          if(!closed)
+            report(diagnostic::kind::unterminated_quote, m_words.words().back());
+          return;
+        }
+        begin(pr, detail::lexer{ line, detail::lexer::default_delimiters(), m_schema->lexing() });
+        run();
+      }
+
+      void begin(parse_resault& pr, detail::lexer&& lx)
+      {
+        m_lx = std::move(lx);
+        m_prelexed = m_schema->lexing().token_array;
+        if(m_prelexed)
+        {
+          m_tokens.lex(m_lx);
+          m_next_token = 0;
+        }
+        start(pr);
+      }
+
+      // the tokens are the stream's (m_fed is parsed a feed() at a time)
+      void begin_stream()
+      {
+        m_fed.emplace(m_resource);
+        m_lx = detail::lexer{};
+        m_prelexed = false;
+        m_streaming = true;
+        m_next_token = 0;
+        m_scanned = 0;
+        start(*m_fed);
+      }
+
+      // the state of a parse of pr at its first token
+      void start(parse_resault& pr)
+      {
+        m_at_known = false;
+        m_commands = m_schema->commands().data();
+        m_current_command = m_commands;
+        m_current_resault_command = &pr.root;
+        m_resault = &pr;
+        pr.m_schema = m_schema;
+        if(!m_visitor)
+          pr.root.init(*m_current_command); // a visit has no resault tree
+        m_last_lookup = {};
+        m_current_token = {};
+        m_peek_token = {};
+        apply_defaults(*m_current_command);
+
+        // load the current and the peek tokens
+        advance();
+        advance();
+      }
+
+      void run()
+      {
+        // a parse that succeeded is past its tokens (a value list stops at a known token so that's parsed next),
+        // one that failed is reported and skipped unless it stopped at a known token (a list without values)
+        while(m_current_token.type != detail::token_type::eof)
+          step();
+
+        if(!(m_streaming ? m_stream.is_valid_utf8() : m_lx.is_valid_utf8()))
+          report(diagnostic::kind::invalid_utf8, {});
+        for(const auto word : m_lx.too_deep_response_files())
+          report(diagnostic::kind::response_file, word);
+      }
+    private:
+      enum class single_delimiter_ : uint8_t
+      {
+        invalid, alias, flag, mutliflag
+      };
+
+      enum class double_delimiter_ : uint8_t
+      {
+        invalid, alias, option
+      };
+
+      enum class identifier : bool 
+      {
+        invalid, subcommand
+      };
+    private:
+      void advance()
+      {
+        m_current_token = m_peek_token;
+        if(m_prelexed)
+          m_peek_token = m_tokens[m_next_token++];
+        else
+          m_peek_token = m_streaming ? m_stream.at(m_next_token++) : m_lx.advance();
+      }
+
+      // parses (or reports and skips) the current token and what goes with it
+      void step()
+      {
+        m_at_known = false;
+        const auto reports = m_reports;
+        if(parse_one())
+          return;
+        if(m_reports == reports)
+          report_unknown();
+        if(!m_at_known)
+          advance();
+      }
+
+      // steps over the fed tokens while can_step(), then drops the ones before the current token
+      void resume()
+      {
+        refresh();
+        while(m_current_token.type != detail::token_type::eof && can_step())
+          step();
+        const auto parsed = m_next_token - 2;
+        m_stream.drop(parsed);
+        m_next_token -= parsed;
+        m_scanned -= std::min(m_scanned, parsed);
+      }
+
+      // the fed text moved (it grew or its start was dropped) so the current and the peek tokens are made again
+      // (and a lookup of the old text can't be taken for a new name at the same address)
+      void refresh()
+      {
+        m_current_token = m_stream.at(m_next_token - 2);
+        m_peek_token = m_stream.at(m_next_token - 1);
+        m_last_lookup = {};
+      }
+
+      // a step from the current token reads at most 8 tokens on (a value, the token after it, one more if it 
+      // fails) unless it's a value list, that stops at a known token (and reads the one after it), so a step is 
+      // sure to read the same tokens it would with the whole line once there's a known token past those 8 and 
+      // the 2 tokens after it were fed, known tokens are of the current command (the one the list would be of)
+      bool can_step()
+      {
+        const size_t count = m_stream.token_count();
+        for(m_scanned = std::max(m_scanned, m_next_token - 2 + 8); m_scanned + 2 < count; m_scanned++)
+        {
+          if(is_known(m_stream.at(m_scanned), m_stream.at(m_scanned + 1)))
+            return true;
+        }
+        return false;
+      }
+
+      // returns true if it could parse this current token and changes the state to the next tokens 
+      // and returns false if it couldn't parse the current token and it requires the state to be advanced
+      bool parse_one()
+      {
+        D_PRINT("parse_one: " << detail::token_type_to_string(m_current_token.type) << " " << m_current_token.literal);
+        return dispatch(m_current_token.type);
+      }
+
+      // the parse that a token of type starts (spaces, '=' and strings can't start anything)
+      // the transitions are this table and the current command's symbol table
+      bool dispatch(detail::token_type type)
+      {
+        using parse_fn = bool (parse_session::*)();
+        static constexpr std::array<parse_fn, 7> table{
+          nullptr,                               // eof
+          &parse_session::parse_identifire,      // identifire
+          nullptr,                               // assign
+          nullptr,                               // string
+          nullptr,                               // space
+          &parse_session::parse_delimiter,       // delimiter
+          &parse_session::parse_double_delimiter // double_delimiter
+        };
+        // the table is indexed by the token type, so it has to follow the enum's order and size
+        using detail::token_type;
+        static_assert(static_cast<size_t>(token_type::eof) == 0 && static_cast<size_t>(token_type::identifire) == 1
+                      && static_cast<size_t>(token_type::assign) == 2 && static_cast<size_t>(token_type::string) == 3
+                      && static_cast<size_t>(token_type::space) == 4 && static_cast<size_t>(token_type::delimiter) == 5
+                      && static_cast<size_t>(token_type::double_delimiter) == 6, "dispatch's table is out of order with token_type");
+        static_assert(table.size() == static_cast<size_t>(token_type::double_delimiter) + 1, "a token_type isn't in dispatch's table");
+        const auto fn = table[static_cast<size_t>(type)];
+        return fn != nullptr && (this->*fn)();
+      }
+
+      bool parse_delimiter()
+      {
+        auto tp = get_single_delimiter_type(m_peek_token);
+        
+        if(!expect_next(detail::token_type::identifire))
+        {
+          // return at the delimiter token require advancment
+          return false; //TODO: error
+        }
+
+        switch(tp)
+        {
+          case single_delimiter_::flag:
+          {
+            save_flag(find_symbol(m_current_token.literal)->flag_index);
+            advance();
+            return true;
+          }
+          case single_delimiter_::alias:
+          {
+            return resolve_alias(true, *find_symbol(m_current_token.literal));
+          }
+          case single_delimiter_::mutliflag:
+          {
+            return resolve_multiflag();
+          }
+          case single_delimiter_::invalid:
+          default:
+          {
+            return false;
+          }
+        }
+      }
+
+      bool parse_double_delimiter()
+      {
+        // we are now at the delimiter token 
+        
+        if(!expect_next(detail::token_type::identifire))
+        {
+          // return at the double_delimiter token require advancment
+          return false;
+        }
+        
+        // we are now at the identifire after the delimiter 
+
+        auto tp = get_double_dlimiter_type(m_current_token);
+        switch(tp)
+        {
+          case double_delimiter_::alias:
+          {
+            return resolve_alias(false, *find_symbol(m_current_token.literal));
+          }
+          case double_delimiter_::option:
+          {
+            return resolve_option(m_current_command->options[find_symbol(m_current_token.literal)->option_index]);
+          }
+          case double_delimiter_::invalid:
+          default:
+          {
+            return false;
+          }
+        }
+      }
+
+
+      // returns true if it can parse the identifier and it's requirement(s)
+      // returns false otherwise and it requires the token to be advanced externally
+      bool parse_identifire()
+      {
+        // stand-alone identifire must be a subcommand 
+        
+        // subcommand check
+        const auto* sym = find_symbol(m_current_token.literal);
+        if(sym && sym->is(detail::symbol::subcommand))
+        {
+          // it's a subcommand resolve it and forward the resolving state
+          return resolve_command(*sym);
+        }
+        
+        // invalid subcommand require advancment
+        return false;
+      }
+
+      //this function is bad
+      bool resolve_alias(bool is_single_delm_call, const detail::symbol& alias)
+      {
+        // if is aliase route to option path
+        if(alias.is(detail::symbol::alias))
+        {
+          //TODO: missmatch check
+          // (freeze() drops aliases of options that don't exist)
+          const auto& opt_spec = m_current_command->options[alias.alias_index];
+          switch(opt_spec.alias_opts)
+          {
+            case option_builder::alias_options::off:
+            {
+              advance();
+              return true;
+            }
+            case option_builder::alias_options::double_delimiter:
+            {
+              if(!is_single_delm_call)
+                return resolve_option(opt_spec);
+            }
+            case option_builder::alias_options::single_delimiter:
+            {
+              if(is_single_delm_call)
+                return resolve_option(opt_spec);
+            }
+          }
+        }
+        return false;
+      }
+
+      bool resolve_option(const option_spec& opt_spec)
+      {
+        // we are now at the options identifire  
+        option opt{ m_resource };
+        auto [value, ends] = values(opt.m_value, opt.m_ends);
+        const auto& extras = extras_of(opt_spec);
+        if(extras.implicit_value && !peek_next(detail::token_type::assign))
+        {
+          // given without a value, only an attached one ('--opt=value') replaces the implicit one
+          advance();
+          return save_preset(opt_spec, *extras.implicit_value, false);
+        }
+        if(opt_spec.requires_value || extras.implicit_value)
+        {
+          if(expect_next(detail::token_type::eof)) // allow any token to be argument only error on eof (expected next token)
+            return report(diagnostic::kind::missing_value, opt_spec.name);
+          
+          advance();
+
+          // we are now at the token after the identifire (might be assign or space) or both
+
+          bool r = false;
+          if(!parse_value_s(value, ends, opt_spec.allows_multiple, r))
+            return report(diagnostic::kind::missing_value, opt_spec.name);
+
+          // lists stay raw (get_vector converts them)
+          if(!opt_spec.allows_multiple && !convert(opt_spec.type, value, opt.m_typed))
+          {
+            report(diagnostic::kind::invalid_value, opt_spec.name);
+            return true; // the tokens are consumed, it's only the value that's bad
+          }
+        }
+        else
+        {
+          // no value, we are done with the identifire
+          advance();
+        }
+        
+        if(extras.bound && !write(extras.bound, value, opt.m_typed))
+          report(diagnostic::kind::invalid_value, opt_spec.name);
+        if(m_visitor)
+          visit_option(opt_spec, value, ends);
+        else if(!extras.bound)
+          save_option(opt_spec, std::move(opt));
+        return true;
+      }
+
+      // the presets and the binding of an option of the current command (none for a static one)
+      const option_extras& extras_of(const option_spec& opt_spec) const
+      {
+        static const option_extras none;
+        const auto& cmd = *m_current_command;
+        return cmd.extras.empty() ? none : cmd.extras[static_cast<size_t>(&opt_spec - cmd.options.data())];
+      }
+
+      // where a value is read into: the resault's strings, or for a visit (that only hands out views) 
+      // the session's scratch ones, so visits don't take anything from the arena
+      std::pair<std::pmr::string&, std::pmr::vector<uint32_t>&> values(std::pmr::string& value, std::pmr::vector<uint32_t>& ends)
+      {
+        if(!m_visitor)
+          return { value, ends };
+        m_scratch.clear();
+        m_scratch_ends.clear();
+        return { m_scratch, m_scratch_ends };
+      }
+
+      // saves a default or an implicit value of an option, they are already converted
+      bool save_preset(const option_spec& opt_spec, const preset_value& preset, bool defaulted)
+      {
+        if(!preset.valid)
+        {
+          report(diagnostic::kind::invalid_value, opt_spec.name);
+          return true;
+        }
+        const auto& bound = extras_of(opt_spec).bound;
+        if(bound)
+        {
+          if(!write(bound, preset.raw, preset.value))
+            report(diagnostic::kind::invalid_value, opt_spec.name);
+          if(m_visitor && !defaulted)
+            visit_option(opt_spec, preset.raw, {});
+          return true;
+        }
+        if(m_visitor)
+        {
+          if(!defaulted)
+            visit_option(opt_spec, preset.raw, {});
+          return true;
+        }
+        option opt{ m_resource };
+        opt.m_value = preset.raw;
+        opt.m_typed = preset.value;
+        opt.m_defaulted = defaulted;
+        save_option(opt_spec, std::move(opt));
+        return true;
+      }
+
+      // a member binding is only written when the session has an object of its class
+      bool write(const binding& b, std::string_view raw, const typed_value& value)
+      {
+        if(b.object_type && (!m_object_type || *b.object_type != *m_object_type))
+          return true;
+        return b.write(m_object, raw, value);
+      }
+
+      // every option of the command that has a default_value starts with it (the command line overrides it)
+      void apply_defaults(const command_spec& cmd_spec)
+      {
+        if(!cmd_spec.has_defaults)
+          return;
+        for(size_t i = 0; i < cmd_spec.options.size(); i++)
+        {
+          if(cmd_spec.extras[i].default_value)
+            save_preset(cmd_spec.options[i], *cmd_spec.extras[i].default_value, true);
+        }
+      }
+
+
+      // the current token is a cluster of one char flags (-xzvf) that get_single_delimiter_type found to be all 
+      // flags, so it's all or nothing: a cluster with a char that isn't a flag is unknown and none of it is saved
+      bool resolve_multiflag()
+      {
+        m_current_command->flag_chars.each(m_current_token.literal, [this] (uint32_t flag_index) {
+          save_flag(flag_index);
+        });
+        advance();
+        return true;
+      }
+
+      bool resolve_command(const detail::symbol& sym)
+      {
+        // we are now at the command identifier
+        
+        const auto& cmd_spec = m_commands[sym.subcommand_index];
+        std::pmr::string saved_value{ m_resource };
+        std::pmr::vector<uint32_t> saved_ends{ m_resource };
+        auto [value, ends] = values(saved_value, saved_ends);
+        if(cmd_spec.requires_value)
+        {
+          if(expect_next(detail::token_type::eof)) // allow any token to be argument only error on eof (expected next token)
+            return report(diagnostic::kind::missing_value, cmd_spec.name); 
+
+          advance();
+
+          // we are now at the token after the command identifire (might be assign or space) or both
+          bool r = false;
+          if(!parse_value_s(value, ends, cmd_spec.allows_multiple, r))
+            return report(diagnostic::kind::missing_value, cmd_spec.name);
+        }
+        else
+        {
+          advance();
+        }
+       
+        auto& added_cmd = save_command(sym, cmd_spec, std::move(value), std::move(ends));
+
+        if(cmd_spec.bound)
+          write(*cmd_spec.bound, {}, {});
+
+        // change the current command to this (resolved) one 
+        change_command(added_cmd, cmd_spec);
+        //advance(); // idon't know in this case if we should advance 
+                   // because of the parse_args (here and in resolve_option)
+                   // TODO: check
+                   // update: it seems like we dont need to advance 
+        return true;
+      }
+
+
+      // reads the arguments into raw and ends (see parse_list)
+      // returns false if there are none and requires the token to be advanced externally
+      bool parse_args(std::pmr::string& raw, std::pmr::vector<uint32_t>& ends)
+      {
+        // we are now at the first argument or the '[' if it's using the argument list syntax
+
+        // if the current token is single Unicode char and it's equal to '[' then it's a list of arguments 
+        
+        //deprecated
+        /*
+        if(utf8::is_single_char(m_current_token.literal) && m_current_token.literal[0] == U'[')
+        {
+          // skip the opening '[' 
+          advance();
+
+          return parse_arguments_list(U']', U',');
+        }
+        */
+        
+        // assume everything else is args (it doesn't now)
+        return parse_list(raw, ends);
+      }
+
+      // returns argument_list as a space separated list if it can parse argument list
+      // it assume everything as argument ( so useres can input arguments with the sam name as a subcommand )
+      // if this behavior is not desired pleas use the argument_list syntax e.g. [ arg arg2 arg3 ]
+      // im not planning to support backtracking the but if i found it to be useful 
+      // i might add it as feature (turned off by default)
+      std::string parse_list_v0()
+      {
+        std::stringstream ss;
+        while(m_current_token.type != detail::token_type::eof)
+        {
+          ss << m_current_token.literal;
+          advance();
+        }
+        return ss.str();
+      }
+
+      // every run of tokens between spaces is one value (so a quoted value or an argv word with spaces in it
+      // stays one), the values are copied into raw separated by a space and ends gets where each one ends
+      bool parse_list(std::pmr::string& raw, std::pmr::vector<uint32_t>& ends)
+      {
+        // we are now at the first item of the list 
+
+        bool in_value = false;
+        while(m_current_token.type != detail::token_type::eof && !parse_known())
+        {
+          if(m_current_token.type == detail::token_type::space)
+          {
+            if(in_value)
+              ends.push_back(static_cast<uint32_t>(raw.size()));
+            in_value = false;
+          }
+          else
+          {
+            if(!in_value && !ends.empty())
+              raw += ' ';
+            raw += m_current_token.literal;
+            in_value = true;
+          }
+          advance();
+        }
+        if(in_value)
+          ends.push_back(static_cast<uint32_t>(raw.size()));
+        return !ends.empty();
+      }
+
+      bool parse_known()
+      {
+        // we are now at the token that might represnt something known 
+        // if so the list stops here and it's parsed next
+        // else we return false (we don't know it)
+        D_PRINT("parse known called: with token: " << detail::token_type_to_string(m_current_token.type) << " literal: " << m_current_token.literal);
+        if(!is_known(m_current_token, m_peek_token))
+          return false;
+        m_at_known = true;
+        return true;
+      }
+
+      // tok (with next, the token after it) starts something the current command knows
+      bool is_known(const detail::token& tok, const detail::token& next)
+      {
+        using detail::token_type;
+
+        switch(tok.type)
+        {
+          case token_type::delimiter:
+          {
+            return get_single_delimiter_type(next) != single_delimiter_::invalid;
+          }
+          case token_type::double_delimiter:
+          {  
+            return get_double_dlimiter_type(next) != double_delimiter_::invalid;
+          }
+          case token_type::identifire:
+          { 
+            const auto* sym = find_symbol(tok.literal);
+            return sym && sym->is(detail::symbol::subcommand);
+          }
+          case token_type::space:
+          default:
+          {
+            return false;
+          }
+        }
+      }
+
+     single_delimiter_ get_single_delimiter_type(const detail::token& tok)
+     {
+       // we check if tok (the token after the delimiter) is a valid sd identifier
+
+       if(tok.type != detail::token_type::identifire)
+        {
+          // return at the delimiter token require advancment
+          return single_delimiter_::invalid; //TODO: error
+        }
+
+       
+        // one probe tells if it's an alias and/or a flag
+        const auto* sym = find_symbol(tok.literal);
+        if(sym && sym->is(detail::symbol::alias))
+          return single_delimiter_::alias;
+
+        if(utf8::is_single_char(tok.literal)) //single char => it's either an alias or a real flag
+        {
+          // not a flag require advancment
+          return sym && sym->is(detail::symbol::flag) ? single_delimiter_::flag : single_delimiter_::invalid;
+        }
+        else // multi char it's either an alias or multiple flags
+        {
+          // so it must be multi-flag or (error)
+          return m_current_command->flag_chars.all(tok.literal) ? single_delimiter_::mutliflag : single_delimiter_::invalid;
+        }
+     }
+
+     double_delimiter_ get_double_dlimiter_type(const detail::token& tok)
+     {
+        // we check if tok is a valid dd identifier
+
+       // we are at the identifier [[old]]
+       
+       
+       if(tok.type != detail::token_type::identifire)
+       //if(m_current_token.type != detail::token_type::identifire)
+       {
+          // return at the double_delimiter token require advancment
+          return double_delimiter_::invalid;
+       }
+
+        // alias check first then a real option, both from the same probe
+        const auto* sym = find_symbol(tok.literal);
+        if(sym && sym->is(detail::symbol::alias))
+          return double_delimiter_::alias;
+        if(sym && sym->is(detail::symbol::option))
+          return double_delimiter_::option;
+        
+        return double_delimiter_::invalid;
+      }
+
+
+      // returns argument_list as a space separated list if it can parse argument list 'till the end(with the closing)
+      // returns "" otherwise and it requires the token to be advanced externally
+      std::string parse_arguments_list(utf8::code_point expect_end, utf8::code_point sep)
+      {
+        // TODO: skip last whitespace(if any) and last comma (if any) 
+        // makes the user life way more easy if they want to auto generate the args list 
+        // like c++ it's valid to do so:
+        // auto x = { 1, 2, 3 , };
+        // currently supporting only comma separated lists e.g. [ arg1, arg2, arg3 ]
+        //TODO: add support for non comma separated lists e.g.  [ arg1 arg2 arg3 ] 
+        //TODO: check me
+        // we are now at the first argument 
+        std::stringstream ss;
+
+        // if the peek token is single Unicode char and it's equal to sep then it's valid 
+        while(utf8::is_single_char(m_peek_token.literal) && m_peek_token.literal[0] == sep)
+        {
+          ss << m_current_token.literal;
+          advance();
+          // we are now at the sep
+          advance();
+          // we are now at the next argument
+        }
+        
+        if(!expect_next(expect_end)) // the state now is before the expected end i.e. at the last argument
+          return {};
+
+        // the state now is at the expect_end token
+        
+        // skip it 
+        advance();
+        return ss.str();
+      }
+
+      bool parse_value_s(std::pmr::string& val, std::pmr::vector<uint32_t>& ends, bool allow_multiple, bool& r) 
+      {
+        // we are now at the token after the identifire (might be assign or space) or both
+
+        // if its a space or assign skip it
+        if(m_current_token.type == detail::token_type::space)
+          advance(); //skip space TODO: or = (chnages the parser)
+        if(m_current_token.type == detail::token_type::assign) // require a value 
+        {
+          r = true; // syntax error
+          advance();
+        }
+
+        // we are now at the value(s) token
+
+        if(allow_multiple)
+        {
+          if(!parse_args(val, ends))
+          {
+            // require advancment
+            return false;
+          }
+        }
+        else 
+        {
+          val = m_current_token.literal;
+          advance();
+        }
+        return true;
+      }
+
+      // checks if peek_token is equal to tt (token wise) if so it advances.
+      // returns true if so,
+      // false otherwise
+      bool expect_next(detail::token_type tt)
+      {
+        if(m_peek_token.type == tt)
+        {
+          advance();
+          return true;
         }
         return false;
       }
 
-      // returns true if it can parse the option and it's requirement(s)
-      // returns false otherwise and it requires the token to be advanced externally
-      bool resolve_option_v0(const std::string& opt_name, const option_builder& opt_build)
-      {       
-        bool rv = false;
-        option opt;
-        D_PRINT("option: current token: " << m_current_token.literal);
-        D_PRINT("opttion: " << opt_name << " builder: " << opt_build.m_name << " req val: " << opt_build.m_requires_value);
-        if(opt_build.m_requires_value)
+      bool peek_next(detail::token_type tt)
+      {
+        if(m_peek_token.type == tt)
+          return true;
+        return false;
+      }
+
+      // checks if peek_token is equal to cp (unicode wise) if so it advances 
+      // returns true if so, 
+      // false otherwise
+      bool expect_next(utf8::code_point cp)
+      {
+        //TODO: check me
+        size_t pos = 0;
+        if(utf8::decode(m_peek_token.literal, pos) == cp && pos >= m_peek_token.literal.size() - 1)
         {
-          if(expect_next(detail::token_type::eof)) // allow any token to be argument only error on eof (expected next token)
-            return false;
-          
-          advance(); 
-          // now at the token after the option identifier
+          advance();
+          return true;
+        }
+        return false;
+      }
 
-          // if its a space or = skip it
-          if(m_current_token.type == detail::token_type::space)
-            advance(); //skip space TODO: or = (chnages the parser)
-          else if(m_current_token.type == detail::token_type::assign) // require a value 
-          {
-            advance();
-            rv = true;
-          }
+      // changes the m_current_resault_command->and the m_current_command to curr_cmd_res and curr_cmd_spec
+      void change_command(command& curr_cmd_res, const command_spec& curr_cmd_spec)
+      {
+        m_current_resault_command = &curr_cmd_res;
+        m_current_command = &curr_cmd_spec;
+        apply_defaults(curr_cmd_spec);
+      }
 
-          // we are now at the option's argument(s)
+      // adds a diagnostic to the resault, returns false so it can be returned from the parse functions
+      bool report(diagnostic::kind type, std::string_view token)
+      {
+        m_reports++;
+        if(m_visitor)
+        {
+          m_visitor->on_diagnostic(type, token);
+          return false;
+        }
+        auto& errors = m_resault->errors;
+        errors.push_back({ type, std::pmr::string{ token, errors.get_allocator() } });
+        return false;
+      }
 
-          if(opt_build.m_allows_multiple)
+      // the current token couldn't be parsed (spaces and such aren't errors)
+      void report_unknown()
+      {
+        using detail::token_type;
+        switch(m_current_token.type)
+        {
+          case token_type::identifire:
+          case token_type::string:
           {
-            const auto& args =  parse_args();
-            if(!args.empty())
-              opt.m_value = args;
-            else 
+            if(m_visitor)
             {
-              // require advancment
-              return false;
+              m_visitor->on_positional(m_current_token.literal);
+              break;
             }
+            report(diagnostic::kind::unknown, m_current_token.literal);
+            break;
           }
-          else 
+          case token_type::delimiter:
+          case token_type::double_delimiter:
           {
-            opt.m_value = m_current_token.literal;
-            advance();
+            report(diagnostic::kind::unknown, m_current_token.literal);
+            break;
+          }
+          default:
+          {
+            break;
           }
         }
-
-        save_option(opt_name, opt);
-        return true;
       }
 
+      // looks name up in the current command's symbol table, a delimiter's identifier is looked up
+      // when it's peeked (to know what it is) and again when it's parsed, the second time is free
+      const detail::symbol* find_symbol(std::string_view name)
+      {
+        if(m_last_lookup.command == m_current_command && m_last_lookup.name.data() == name.data() 
+           && m_last_lookup.name.size() == name.size())
+          return m_last_lookup.sym;
+
+        m_last_lookup = { m_current_command, name, m_current_command->symbols.find(name) };
+        return m_last_lookup.sym;
+      }
 
-      bool resolve_option(const std::string& opt_name, const option_builder& opt_build)
+      // stores opt in its slot of the current resault command (opt_spec is one of the current command's)
+      // (or tells the visitor)
+      void save_option(const option_spec& opt_spec, option&& opt)
       {
-        // we are now at the options identifire  
-        option opt;
-        if(opt_build.m_requires_value)
-        {
-          if(expect_next(detail::token_type::eof)) // allow any token to be argument only error on eof (expected next token)
-            return false;
-          
-          advance();
+        auto& cmd = *m_current_resault_command;
+        const auto index = static_cast<size_t>(&opt_spec - m_current_command->options.data());
+        auto& saved = cmd.m_options[index];
+        saved = std::move(opt);
+        cmd.set_present(cmd.option_bit(index));
+      }
 
-          // we are now at the token after the identifire (might be assign or space) or both
+      void visit_option(const option_spec& opt_spec, std::string_view value, std::span<const uint32_t> ends)
+      {
+        const auto index = static_cast<uint32_t>(&opt_spec - m_current_command->options.data());
+        m_visitor->on_option({ index }, opt_spec.name, value, ends);
+      }
 
-          bool r = false;
-          if(!parse_value_s(opt.m_value, opt_build.m_allows_multiple, r))
-            return false;
+      // (re)starts the subcommand's slot of the current resault command
+      command& save_command(const detail::symbol& sym, const command_spec& cmd_spec, std::pmr::string&& value, 
+                            std::pmr::vector<uint32_t>&& ends)
+      {
+        if(m_visitor)
+        {
+          m_visitor->on_command({ sym.child_index }, cmd_spec.name, value, ends);
+          return *m_current_resault_command; // a visit stays in the (unused) root
         }
-        
-        save_option(opt_name, opt);
-        return true;
+        auto& cmd = *m_current_resault_command;
+        auto& saved = cmd.m_commands[sym.child_index];
+        saved.init(cmd_spec);
+        saved.m_value = std::move(value);
+        saved.m_ends = std::move(ends);
+        cmd.set_present(cmd.command_bit(sym.child_index));
+        return saved;
       }
 
+      void save_flag(uint32_t flag_index)
+      {
+        if(m_visitor)
+          return m_visitor->on_flag({ flag_index }, m_current_command->flags[flag_index]);
+        auto& cmd = *m_current_resault_command;
+        cmd.set_present(cmd.flag_bit(flag_index));
+      }
 
-      // returns true if it can parse the multi-flags and resolve each one of them
-      // returns false otherwise and it requires the token to be advanced externally
-      // TODO: maybe allow to enable resolving the rest of the flags 
-      // if one of the flags are not correct,
-      // or add some more configurations to this function
-      // because the behavior now is if a flag isn't correct 
-      // we return immedatly but there might be another flags in front of it 
-      // that won't be resolved or even checked.
-      bool resolve_multiflag_v0()
-      {
-        // we are now at the identifier next to the delimiter
-        // that we suspect is multiflag
-
-        size_t pos = 0, end_pos = 0;
-        bool state = true;
-        while(end_pos < m_current_token.literal.size() && state)
-        {
-          state = utf8::advance_one_char(m_current_token.literal, end_pos);
-          const auto& str = m_current_token.literal.substr(pos, end_pos);
-          const auto& flag_it = m_current_command->m_flags.find(str);
-          pos = end_pos;
-
-          // check if the current flag is valid
-          if(m_current_command->m_flags.end() == flag_it)
-          {
-            // invlaid flag require advancment (skip the whole flags identifier even if some are correct)
-            return false;
-          }
+      // deprecated
+      //parse_resault build_base_resault()
+      //{
+        // just copy the skeleton of the builder(s)
+      //  parse_resault pr;
+        //pr.root = add_command(m_root);
+      //  return pr;
+      //}
 
-          add_flag(str);
-        }
+      //command add_command(const command_builder& cmd_build)
+      //{
+      //  command cmd;
 
-        // we are done with this identifier advance it
-        advance();
-        return true;
+      //  for(const auto& subcmd_build : cmd_build.m_subcommands)
+      //  {
+      //    auto c = add_command(subcmd_build.second);
+      //    cmd.m_commands[subcmd_build.first] = {};
+      //  }
+
+      //  for(const auto& opt_build : cmd_build.m_options)
+      //  {
+      //    cmd.m_options[opt_build.first] = option{};
+      //  }
+
+      //  for(const auto& flag_name : cmd_build.m_flags)
+      //  {
+      //    cmd.m_flags[flag_name] = flag{};
+      //  }
+      //  return cmd;
+      //}
+    private:
+      std::shared_ptr<const schema> m_schema;
+      detail::counting_resource m_upstream;
+      std::unique_ptr<std::byte[]> m_buffer;
+      size_t m_buffer_size{ 0 };
+      std::optional<std::pmr::monotonic_buffer_resource> m_arena;
+      std::pmr::memory_resource* m_resource;
+
+      detail::lexer m_lx;
+      detail::token_array m_tokens; // all of m_lx when the schema lexes up front
+      size_t m_next_token{ 0 };
+      bool m_prelexed{ false };
+      detail::stream_lexer m_stream; // the line that feed() is given
+      std::optional<parse_resault> m_fed; // its resault, parsed as it's fed
+      bool m_streaming{ false };          // the tokens are m_stream's (from m_next_token)
+      size_t m_scanned{ 0 };              // can_step() didn't find a known token before this one
+      detail::shell_words m_words;   // of a line when the schema splits lines like a shell
+      parse_visitor* m_visitor{ nullptr }; // the parse is a visit (nothing is saved in the resault)
+      // the value a visit is reading (see values()), from the heap unless the session was given a resource
+      std::pmr::string m_scratch{ std::pmr::new_delete_resource() };
+      std::pmr::vector<uint32_t> m_scratch_ends{ std::pmr::new_delete_resource() };
+      recorder m_recorder;
+      size_t m_reports{ 0 };               // diagnostics reported so far (to tell if a parse function reported one)
+      bool m_at_known{ false }; // a value list stopped at a known token (it's parsed next)
+      detail::token m_current_token,
+                    m_peek_token;
+      const command_spec* m_commands{ nullptr }; // the schema's commands, root first
+      const command_spec* m_current_command{ nullptr };
+      struct
+      {
+        const command_spec* command{ nullptr };
+        std::string_view name;
+        const detail::symbol* sym{ nullptr };
+      } m_last_lookup;
+      command* m_current_resault_command{ nullptr };
+      parse_resault* m_resault{ nullptr };
+      void* m_object{ nullptr }; // the target of member bindings
+      const std::type_info* m_object_type{ nullptr };
+    };
+
+    // the resaults of parse_many in input order, they live in the arenas of the worker sessions
+    // the batch owns (so they are valid as long as the batch is)
+    class batch_resault 
+    {
+    public:
+      batch_resault(const batch_resault&) = delete;
+      batch_resault& operator=(const batch_resault&) = delete;
+
+      batch_resault(batch_resault&& other) noexcept
+        : m_sessions(std::move(other.m_sessions)), m_resaults(std::exchange(other.m_resaults, {})), 
+          m_error_count(other.m_error_count), m_seconds(other.m_seconds)
+      {
       }
 
-      bool resolve_multiflag(bool continue_on_error = false, std::vector<std::string>* error_flags = nullptr) {
-    // returns true if it can parse the multi-flags and resolve each one of them
-    // returns false otherwise and it requires the token to be advanced externally
-    // TODO: maybe allow to enable resolving the rest of the flags
-    // if one of the flags are not correct,
-    // or add some more configurations to this function
-    // because the behavior now is if a flag isn't correct
-    // we return immedatly but there might be another flags in front of it
-    // that won't be resolved or even checked.
+      batch_resault& operator=(batch_resault&& other) noexcept
+      {
+        if(this == &other)
+          return *this;
+        destroy();
+        m_sessions = std::move(other.m_sessions);
+        m_resaults = std::exchange(other.m_resaults, {});
+        m_error_count = other.m_error_count;
+        m_seconds = other.m_seconds;
+        return *this;
+      }
 
-    // we are now at the identifier next to the delimiter
-    // that we suspect is multiflag
+      // the arenas don't run destructors, and a resault holds on to its schema
+      ~batch_resault()
+      {
+        destroy();
+      }
 
-    if (m_current_token.literal.empty()) { //add a check for empty token.
-        return true; //Or return false, depending on the desired behavior.
-    }
-    // TODO: add an option to validate all flags then run them because in some tools
-    // running a command with some flags and not the others can be wrong
-    // so better to error than to do something you are not supposed to 
-    // rm -rf
-    size_t pos = 0, end_pos = 0;
-    bool all_flags_valid = true; // Use a flag to track overall validity
-
-    while (end_pos < m_current_token.literal.size()) {
-        bool advance_success = utf8::advance_one_char(m_current_token.literal, end_pos);
-        if (!advance_success) {
-            // Handle UTF-8 error (e.g., invalid character)
-            // TODO: Add error handling for invalid UTF-8
-            if(error_flags){
-                error_flags->push_back("Invalid UTF-8 character");
-            }
-            return false;
-        }
+      size_t size() const
+      {
+        return m_resaults.size();
+      }
 
-        const auto& str = m_current_token.literal.substr(pos, end_pos);
-        
-        const auto& flag_it = m_current_command->m_flags.find(str);
-        pos = end_pos;
-        // check if the current flag is not valid
-        if (m_current_command->m_flags.end() == flag_it) {
-            // invalid flag
-            all_flags_valid = false;
-            if (error_flags) {
-                error_flags->push_back(str); // Report the invalid flag
-            }
+      const parse_resault& operator[](size_t i) const
+      {
+        return *m_resaults[i];
+      }
 
-            if (!continue_on_error) {
-                // Stop processing on the first error
-                return false;
-            }
-        } else {
-            save_flag(str, {}); // Add the valid flag
-        }
-    }
+      // the number of lines with at least one diagnostic
+      size_t error_count() const
+      {
+        return m_error_count;
+      }
 
-    // we are done with this identifier advance it
-    advance();
-    return true; // Return true even if not all flags are valid 'cause we already advanced 
-                 // idk if we should only advance if all are valid? 
-}
+      double seconds() const
+      {
+        return m_seconds;
+      }
 
-      // returns true if it can parse the command and it's requirement(s)
-      // returns false otherwise and it requires the token to be advanced externally
-      bool resolve_command_v0(const std::string& name, command_builder& cmd_build)
+      double lines_per_second() const
       {
-        // we are now at the command identifier
-        
-        command cmd;
-        if(cmd_build.m_requires_value)
-        {
-          if(!expect_next(detail::token_type::eof)) // allow any token to be argument only error on eof (expected next token)
-            return false; 
+        return m_seconds > 0.0 ? static_cast<double>(size()) / m_seconds : 0.0;
+      }
+    private:
+      batch_resault() = default;
 
-          // we are now at the next token after the option 
+      // before the sessions (and their arenas) go
+      void destroy()
+      {
+        for(auto* pr : m_resaults)
+          std::destroy_at(pr);
+        m_resaults.clear();
+      }
 
-          if(cmd_build.m_allows_multiple)
-          {
-            const auto& args = parse_args();
-            if(!args.empty())
-              cmd.m_value = args;
-            else 
-            {
-              // require advancement //RIGHT
-              return false;
-            }
-          }
-          else
+      // every worker parses with its own session (and arena) and takes chunks of lines,
+      // stealing from the others once it's out of its own
+      template <typename ITEM>
+      void parse(const std::shared_ptr<const schema>& sc, std::span<const ITEM> items, size_t threads)
+      {
+        constexpr size_t chunk = 64;
+        const auto start = std::chrono::steady_clock::now();
+        if(threads == 0)
+          threads = std::max(1u, std::thread::hardware_concurrency());
+        threads = std::max<size_t>(1, std::min(threads, items.size()));
+
+        m_resaults.resize(items.size());
+        m_sessions.resize(threads);
+        for(auto& session : m_sessions)
+          session = std::make_unique<parse_session>(sc);
+
+        struct alignas(detail::cache_line_size) counter
+        {
+          size_t errors{ 0 };
+        };
+        std::vector<counter> errors(threads);
+
+        detail::parallel_for(items.size(), threads, chunk, [&](size_t w, size_t begin, size_t end) {
+          auto& session = *m_sessions[w];
+          std::pmr::polymorphic_allocator<> alloc{ session.resource() };
+          for(size_t i = begin; i < end; i++)
           {
-            cmd.m_value = m_current_token.literal;
+            // the resault is moved into the arena too (destroyed by destroy(), the arena frees its memory)
+            m_resaults[i] = alloc.new_object<parse_resault>(session.parse(items[i]));
+            errors[w].errors += m_resaults[i]->has_error();
           }
-        }
-        else
-        {
-          advance();
-        }
-       
-        // TODO: refactor this so you add it first and work on the reference instead of
-        // copying it again when you add it 
-        auto& added_cmd = save_command(name, cmd);
+        });
 
-        // change the current command to this (resolved) one 
-        change_command(added_cmd, cmd_build);
-        //advance(); // idon't know in this case if we should advance 
-                   // because of the parse_args (here and in resolve_option)
-                   // TODO: check
-                   // update: it seems like we dont need to advance 
-        return true;
+        for(const auto& c : errors)
+          m_error_count += c.errors;
+        m_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
       }
+    private:
+      std::vector<std::unique_ptr<parse_session>> m_sessions;
+      std::vector<parse_resault*> m_resaults;
+      size_t m_error_count{ 0 };
+      double m_seconds{ 0.0 };
+    private:
+      friend batch_resault parse_many(const std::shared_ptr<const schema>&, std::span<const std::string_view>, size_t);
+      friend batch_resault parse_many(const std::shared_ptr<const schema>&, std::span<const std::span<char* const>>, size_t);
+    };
 
-      bool resolve_command(const std::string& name, command_builder& cmd_build)
-      {
-        // we are now at the command identifier
-        
-        command cmd;
-        if(cmd_build.m_requires_value)
-        {
-          if(!expect_next(detail::token_type::eof)) // allow any token to be argument only error on eof (expected next token)
-            return false; 
+    // parses every line against sc on 'threads' threads (0 is one per core)
+    inline batch_resault parse_many(const std::shared_ptr<const schema>& sc, std::span<const std::string_view> lines, size_t threads = 0)
+    {
+      batch_resault br;
+      br.parse(sc, lines, threads);
+      return br;
+    }
 
-          // we are now at the next token after the option 
-          bool r = false;
-          if(parse_value_s(cmd.m_value, cmd_build.m_allows_multiple, r))
-            return false;
-        }
-        else
-        {
-          advance();
-        }
-       
-        // TODO: refactor this so you add it first and work on the reference instead of
-        // copying it again when you add it 
-        auto& added_cmd = save_command(name, cmd);
+    // same as above but each item is an argv (without the launch command name)
+    inline batch_resault parse_many(const std::shared_ptr<const schema>& sc, std::span<const std::span<char* const>> argvs, size_t threads = 0)
+    {
+      batch_resault br;
+      br.parse(sc, argvs, threads);
+      return br;
+    }
 
-        // change the current command to this (resolved) one 
-        change_command(added_cmd, cmd_build);
-        //advance(); // idon't know in this case if we should advance 
-                   // because of the parse_args (here and in resolve_option)
-                   // TODO: check
-                   // update: it seems like we dont need to advance 
-        return true;
+    template <typename C>
+    parse_resault parser::parse_into(C& object, int argc, char** argv) const
+    {
+      parse_session session{ freeze(), std::pmr::get_default_resource() };
+      session.bind_object(object);
+      return session.parse(argc, argv);
+    }
+
+    inline parse_resault parser::parse(int argc, char** argv) const
+    {
+      return parse_session{ freeze(), std::pmr::get_default_resource() }.parse(argc, argv);
+    }
+
+    inline parse_resault parser::parse(std::span<char* const> args) const
+    {
+      return parse_session{ freeze(), std::pmr::get_default_resource() }.parse(args);
+    }
+
+    inline parse_resault parser::parse(std::string_view line) const
+    {
+      return parse_session{ freeze(), std::pmr::get_default_resource() }.parse(line);
+    }
+
+    // a schema known at compile time, declared as a type instead of with add_* calls:
+    //
+    //   using cli = static_command<"tool",
+    //     static_option<"threads", int64_t>,
+    //     static_alias<"j", "threads">,
+    //     static_option<"include", std::string, { .allows_multiple = true }>,
+    //     static_flag<"v">,
+    //     static_command<"remote", static_option<"url">>>;
+    //
+    // the specs and the perfect hash tables of every command are static constexpr arrays (constant initialized,
+    // no map or hash table is built at startup), names that clash are compile errors and get<"threads">() is
+    // a handle known at compile time
+
+    // a name as a template argument
+    template <size_t N>
+    struct fixed_name
+    {
+      char chars[N]{};
+
+      constexpr fixed_name() = default;
+
+      consteval fixed_name(const char (&str)[N])
+      {
+        std::copy_n(str, N, chars);
+      }
+
+      constexpr std::string_view view() const
+      {
+        return { chars, N - 1 };
       }
+    };
+
+    // what a declaration of a static_command is
+    enum class static_kind : uint8_t
+    {
+      option, flag, alias, value, command
+    };
+
+    // what requires_value(), allow_multiple() and set_alias_options() set on a builder
+    struct static_traits
+    {
+      bool requires_value{ false };
+      bool allows_multiple{ false };
+      option_builder::alias_options alias_opts{ option_builder::alias_options::_default };
+    };
 
+    // a declaration of a static_command as data, the declarations of a command are checked and compiled
+    // by looping over an array of these (a fold per declaration would instantiate something for each of them
+    // whose name has all of them in it, which is quadratic in compile time)
+    struct static_declaration
+    {
+      static_kind kind{ static_kind::option };
+      std::string_view name;
+      std::string_view option;   // the option an alias names
+      size_t command_count{ 0 }; // a subcommand's (with its own subcommands)
+      option_spec spec;          // an option's
+      static_traits traits;      // a static_value's
+    };
 
-      // returns argument_list as a space separated list if it can parse the arguments 
-      // returns "" otherwise and requires the token to be advanced externally
-      std::string parse_args()
+    // T is what .as<T>() would be (void for a raw option)
+    template <fixed_name NAME, typename T = void, static_traits TRAITS = {}>
+    struct static_option
+    {
+      static constexpr option_builder::value_type type()
       {
-        // we are now at the first argument or the '[' if it's using the argument list syntax
+        if constexpr(std::is_void_v<T>)
+          return option_builder::value_type::raw;
+        else
+          return option_builder::value_type_of<T>();
+      }
 
-        // if the current token is single Unicode char and it's equal to '[' then it's a list of arguments 
-        
-        //deprecated
-        /*
-        if(utf8::is_single_char(m_current_token.literal) && m_current_token.literal[0] == U'[')
-        {
-          // skip the opening '[' 
-          advance();
+      static constexpr static_declaration declaration{ .kind = static_kind::option, .name = NAME.view(), .option = {}, .command_count = 0, 
+        .spec = { .name = NAME.view(), .requires_value = TRAITS.requires_value || !std::is_void_v<T>, .allows_multiple = TRAITS.allows_multiple, 
+                  .alias_opts = TRAITS.alias_opts, .type = type() }, 
+        .traits = {} };
+    };
 
-          return parse_arguments_list(U']', U',');
-        }
-        */
-        
-        // assume everything else is args (it doesn't now)
-        return parse_list();
+    template <fixed_name NAME>
+    struct static_flag
+    {
+      static_assert(utf8::is_single_char(NAME.view()), "a flag is one utf-8 char");
+
+      static constexpr static_declaration declaration{ .kind = static_kind::flag, .name = NAME.view(), .option = {}, .command_count = 0, 
+                                                       .spec = {}, .traits = {} };
+    };
+
+    // set_option_alias(ALIAS, OPTION)
+    template <fixed_name ALIAS, fixed_name OPTION>
+    struct static_alias
+    {
+      static constexpr static_declaration declaration{ .kind = static_kind::alias, .name = ALIAS.view(), .option = OPTION.view(), 
+                                                       .command_count = 0, .spec = {}, .traits = {} };
+    };
+
+    // the traits of the command it's declared in (requires_value and allows_multiple)
+    template <static_traits TRAITS>
+    struct static_value
+    {
+      static constexpr static_declaration declaration{ .kind = static_kind::value, .name = {}, .option = {}, .command_count = 0, 
+                                                       .spec = {}, .traits = TRAITS };
+    };
+
+    // what get<"name">() of a static_command resolves to
+    struct static_entry
+    {
+      static_kind kind{ static_kind::option };
+      uint32_t index{ 0 };  // the handle (an alias is its option's)
+      size_t position{ 0 }; // of the declaration in the command
+      size_t matches{ 0 };
+    };
+
+    // the declarations of a static_command, checked and turned into its tables at compile time
+    // (everything here runs in constant expressions, the vectors don't outlive them)
+    template <size_t N>
+    struct static_declarations
+    {
+      std::array<static_declaration, N> all;
+
+      constexpr size_t count(static_kind k) const
+      {
+        return static_cast<size_t>(std::ranges::count(all, k, &static_declaration::kind));
       }
 
-      // returns argument_list as a space separated list if it can parse argument list
-      // it assume everything as argument ( so useres can input arguments with the sam name as a subcommand )
-      // if this behavior is not desired pleas use the argument_list syntax e.g. [ arg arg2 arg3 ]
-      // im not planning to support backtracking the but if i found it to be useful 
-      // i might add it as feature (turned off by default)
-      std::string parse_list_v0()
+      // the position of the i'th declaration of kind k
+      constexpr size_t position(static_kind k, size_t i) const
       {
-        std::stringstream ss;
-        while(m_current_token.type != detail::token_type::eof)
+        for(size_t p = 0; p < N; p++)
         {
-          ss << m_current_token.literal;
-          advance();
+          if(all[p].kind == k && i-- == 0)
+            return p;
         }
-        return ss.str();
+        return N;
       }
 
-      std::string parse_list()
+      // sorted
+      constexpr std::vector<std::string_view> names(static_kind k) const
       {
-        // we are now at the first item of the list 
-
-        std::stringstream ss;
-        while(m_current_token.type != detail::token_type::eof)
+        std::vector<std::string_view> out;
+        for(const auto& decl : all)
         {
-          if(parse_known())
-          {
-            return ss.str();
-          }
-          else 
-          { 
-            ss << m_current_token.literal;
-            advance();
-          };
+          if(decl.kind == k)
+            out.push_back(decl.name);
         }
-        return ss.str();
+        std::ranges::sort(out);
+        return out;
       }
 
-      std::vector<std::function<bool(void)>> m_to_parse;
-      template <typename FUN>
-      void schedual_parse(FUN&& fun)
+      constexpr bool unique(static_kind k) const
       {
-        m_to_parse.emplace_back(fun);
+        const auto sorted = names(k);
+        return std::ranges::adjacent_find(sorted) == sorted.end();
       }
 
-      bool parse_known()
+      constexpr bool aliases_resolve() const
       {
-        // we are now at the token that might represnt something known 
-        // if so we parse it 
-        // else we return false (we don't know it)
-        
-
-        D_PRINT("parse known called: with token: " << detail::token_type_to_string(m_current_token.type) << " literal: " << m_current_token.literal);
-        using detail::token_type;
+        const auto options = names(static_kind::option);
+        return std::ranges::all_of(all, [&](const static_declaration& decl) {
+          return decl.kind != static_kind::alias || std::ranges::binary_search(options, decl.option);
+        });
+      }
 
-        switch(m_current_token.type)
-        {
-          case token_type::delimiter:
-          {
-            D_PRINT("i know that one trying to parse...");
-            auto sd = get_single_delimiter_type();
-            if(sd != single_delimiter_::invalid)
-            {
-              schedual_parse([this] (){return parse_delimiter();});
-              return true;
-              //auto d = parse_delimiter();
-              //D_PRINT("parse resault: " << (d ? "true" : " false"));
-              //return d;
-            }
-            return false;
-          }
-          case token_type::double_delimiter:
-          {  
-            D_PRINT("i know that one trying to parse...");
-            auto dd = get_double_dlimiter_type(m_peek_token);
-            if(dd != double_delimiter_::invalid)
-            {
-              schedual_parse([this] (){return parse_double_delimiter();});
-              return true;
-              //auto d = parse_double_delimiter();
-              //D_PRINT("parse resault: " << (d ? "true" : " false"));
-              //return d;
-            }
-            return false;
-          }
-          case token_type::identifire:
-          { 
-            auto sub_it = m_current_command->m_subcommands.find(m_current_token.literal);
-            if(m_current_command->m_subcommands.end() != sub_it)
-            {
-              schedual_parse([this] (){return parse_identifire();});
-              return true;
-            }
-            //D_PRINT("i know that one trying to parse...");
-            //auto d = parse_identifire();
-            //D_PRINT("parse resault: " << (d ? "true" : " false"));
-            //return d;
-          }
-          case token_type::space:
-          default:
-          {
-            D_PRINT("nah idon't parse this one!");
-            return false;
-          }
-        }
+      // an alias can't be an option, a flag or another alias too ('-v' would mean two things)
+      constexpr bool aliases_clash() const
+      {
+        const auto options = names(static_kind::option);
+        const auto flags = names(static_kind::flag);
+        const auto aliases = names(static_kind::alias);
+        if(std::ranges::adjacent_find(aliases) != aliases.end())
+          return true;
+        return std::ranges::any_of(aliases, [&](std::string_view alias) { 
+          return std::ranges::binary_search(options, alias) || std::ranges::binary_search(flags, alias); 
+        });
       }
 
-     single_delimiter_ get_single_delimiter_type()
-     {
-       // now we are at identifier token we will try to parse it and if we fail 
-        // we will return at it and we will require advancment
+      constexpr static_traits value() const
+      {
+        const auto it = std::ranges::find(all, static_kind::value, &static_declaration::kind);
+        return it != all.end() ? it->traits : static_traits{};
+      }
 
-       single_delimiter_ type;
-       if(m_current_token.type != detail::token_type::identifire)
+      // the handle of the option named option
+      constexpr uint32_t option_index(std::string_view option) const
+      {
+        uint32_t index = 0;
+        for(const auto& decl : all)
         {
-          // return at the delimiter token require advancment
-          return single_delimiter_::invalid; //TODO: error
+          if(decl.kind != static_kind::option)
+            continue;
+          if(decl.name == option)
+            return index;
+          index++;
         }
+        return 0;
+      }
 
-       
-        //FIXME: there is a repeated alias check D.R.Y
+      // the commands (counted with their subcommands) declared before position
+      constexpr uint32_t commands_before(size_t position) const
+      {
+        uint32_t sum = 0;
+        for(size_t p = 0; p < position; p++)
+          sum += static_cast<uint32_t>(all[p].command_count);
+        return sum;
+      }
 
-        if(utf8::is_single_char(m_current_token.literal)) //single char => it's either an alias or a real flag
+      constexpr static_entry find(std::string_view name) const
+      {
+        static_entry out;
+        uint32_t handles[static_cast<size_t>(static_kind::command) + 1]{};
+        for(size_t p = 0; p < N; p++)
         {
-          // check if it's an alias
-          const auto& alias_it = m_current_command->m_options_aliases.find(m_current_token.literal);
-          if(m_current_command->m_options_aliases.end() != alias_it)
+          const auto k = all[p].kind;
+          if(k != static_kind::value && all[p].name == name)
           {
-            // if it's an alias resolve it and forward resolving state
-            return single_delimiter_::alias;
+            out = { k, handles[static_cast<size_t>(k)], p, out.matches + 1 };
+            if(k == static_kind::alias)
+              out = { static_kind::option, option_index(all[p].option), p, out.matches };
           }
-          
-          // it's not an alias so it might be a flag
-          
-          // flag check
-          const auto& flag_it = m_current_command->m_flags.find(m_current_token.literal);
-          if(m_current_command->m_flags.end() != flag_it)
+          handles[static_cast<size_t>(k)]++;
+        }
+        return out;
+      }
+
+      // one entry per name (a name can be many things at once), the subcommands of the command at schema
+      // index 'index' are after it depth first
+      constexpr std::vector<detail::symbol> symbols(uint32_t index) const
+      {
+        std::vector<detail::symbol> sorted;
+        sorted.reserve(N);
+        uint32_t options = 0;
+        uint32_t flags = 0;
+        uint32_t children = 0;
+        uint32_t next = index + 1;
+        for(const auto& decl : all)
+        {
+          switch(decl.kind)
           {
-            // so it's a flag save it and advance then return true
-            //flag f{};
-            //m_current_resault_command->m_flags[m_current_token.literal] = f;
-            return single_delimiter_::flag;
+            case static_kind::option:
+              sorted.push_back({ .name = decl.name, .kinds = detail::symbol::option, .option_index = options++ });
+              break;
+            case static_kind::alias:
+              sorted.push_back({ .name = decl.name, .kinds = detail::symbol::alias, .alias_index = option_index(decl.option) });
+              break;
+            case static_kind::flag:
+              sorted.push_back({ .name = decl.name, .kinds = detail::symbol::flag, .flag_index = flags++ });
+              break;
+            case static_kind::command:
+              sorted.push_back({ .name = decl.name, .kinds = detail::symbol::subcommand, .subcommand_index = next, .child_index = children++ });
+              next += static_cast<uint32_t>(decl.command_count);
+              break;
+            case static_kind::value:
+              break;
           }
-          // not a flag require advancment
-          return single_delimiter_::invalid;
         }
-        else // multi char it's either an alias or multiple flags
+
+        std::ranges::sort(sorted, {}, &detail::symbol::name);
+        std::vector<detail::symbol> merged;
+        for(const auto& sym : sorted)
         {
-          // alias check
-          const auto& alias_it = m_current_command->m_options_aliases.find(m_current_token.literal);
-          if(m_current_command->m_options_aliases.end() != alias_it)
+          if(merged.empty() || merged.back().name != sym.name)
           {
-            // if it's an alias resolve it and forward resolving state
-            return single_delimiter_::alias;
+            merged.push_back(sym);
+            continue;
+          }
+          auto& into = merged.back();
+          into.kinds |= sym.kinds;
+          if(sym.is(detail::symbol::option))
+            into.option_index = sym.option_index;
+          if(sym.is(detail::symbol::alias))
+            into.alias_index = sym.alias_index;
+          if(sym.is(detail::symbol::flag))
+            into.flag_index = sym.flag_index;
+          if(sym.is(detail::symbol::subcommand))
+          {
+            into.subcommand_index = sym.subcommand_index;
+            into.child_index = sym.child_index;
           }
-          
-          // so it must be multi-flag or (error)
-          return is_multiflag() ? single_delimiter_::mutliflag : parser::single_delimiter_::invalid;
         }
-     }
-
-     double_delimiter_ get_double_dlimiter_type(const detail::token& tok)
-     {
-        // we check if tok is a valid dd identifier
+        return merged;
+      }
 
-       // we are at the identifier [[old]]
-       
-       
-       if(tok.type != detail::token_type::identifire)
-       //if(m_current_token.type != detail::token_type::identifire)
-       {
-          // return at the double_delimiter token require advancment
-          return double_delimiter_::invalid;
-       }
+      constexpr detail::symbol_table table(uint32_t index) const
+      {
+        return detail::symbol_table{ symbols(index) };
+      }
 
-        // alias check
-        const auto& alias_it = m_current_command->m_options_aliases.find(tok.literal);
-        if(m_current_command->m_options_aliases.end() != alias_it)
-        {
-          // if it's an alias resolve it and forward the resolving state
-          return double_delimiter_::alias;
-        }
-        
-        // it's not an alias so check if it's a real option
-        const auto& opt_it = m_current_command->m_options.find(tok.literal);
-        if(m_current_command->m_options.end() != opt_it)
+      // the first 'size' declarations of kind k as what get() makes of one
+      template <size_t SIZE, typename GET>
+      constexpr auto gather(static_kind k, GET get) const
+      {
+        std::array<std::invoke_result_t<GET, const static_declaration&>, SIZE> out{};
+        size_t i = 0;
+        for(const auto& decl : all)
         {
-          // if it's an option resolve it and forward the resolving state
-          return double_delimiter_::option;
+          if(decl.kind == k && i < SIZE)
+            out[i++] = get(decl);
         }
-        
-        return double_delimiter_::invalid;
+        return out;
       }
+    };
 
-
-    bool is_multiflag(bool continue_on_error = false) 
+    // a (sub)command of a static schema, NAME is how it's written on the command line (the root's isn't used)
+    template <fixed_name NAME, typename... DECLS>
+    struct static_command
     {
-    // returns true if it can parse the multi-flags and resolve each one of them
-    // returns false otherwise and it requires the token to be advanced externally
-    // TODO: maybe allow to enable resolving the rest of the flags
-    // if one of the flags are not correct,
-    // or add some more configurations to this function
-    // because the behavior now is if a flag isn't correct
-    // we return immedatly but there might be another flags in front of it
-    // that won't be resolved or even checked.
+      static constexpr static_declarations<sizeof...(DECLS)> declarations{ { DECLS::declaration... } };
 
-    // we are now at the identifier next to the delimiter
-    // that we suspect is multiflag
-
-    bool ret = false;
-    std::string copy = m_current_token.literal;
-    if (copy.empty()) { //add a check for empty token.
-        return false; //Or return false, depending on the desired behavior.
-    }
-    // TODO: add an option to validate all flags then run them because in some tools
-    // running a command with some flags and not the others can be wrong
-    // so better to error than to do something you are not supposed to 
-    // rm -rf
-    size_t pos = 0, end_pos = 0;
-    bool all_flags_valid = true; // Use a flag to track overall validity
-
-    while (end_pos < copy.size()) {
-        bool advance_success = utf8::advance_one_char(m_current_token.literal, end_pos);
-        if (!advance_success) {
-            // Handle UTF-8 error (e.g., invalid character)
-            // TODO: Add error handling for invalid UTF-8
-            
-          //if(error_flags){
-          //      error_flags->push_back("Invalid UTF-8 character");
-          //  }
-            return false;
-        }
+      static_assert(declarations.unique(static_kind::option), "two options of a static_command have the same name");
+      static_assert(declarations.unique(static_kind::flag), "two flags of a static_command have the same name");
+      static_assert(declarations.unique(static_kind::command), "two subcommands of a static_command have the same name");
+      static_assert(declarations.aliases_resolve(), "a static_alias names an option that its command doesn't have");
+      static_assert(!declarations.aliases_clash(), "a static_alias has the name of an option, a flag or another alias of its command");
+      static_assert(declarations.count(static_kind::value) <= 1, "a static_command has one static_value at most");
 
-        const auto& str = copy.substr(pos, end_pos);
-        
-        const auto& flag_it = m_current_command->m_flags.find(str);
-        pos = end_pos;
-        // check if the current flag is not valid
-        if (m_current_command->m_flags.end() == flag_it) {
-            // invalid flag
-            all_flags_valid = false;
-            //if (error_flags) {
-            //    error_flags->push_back(str); // Report the invalid flag
-            //}
+      static constexpr size_t command_count = 1 + (size_t{ 0 } + ... + DECLS::declaration.command_count);
+      static constexpr static_declaration declaration{ .kind = static_kind::command, .name = NAME.view(), .option = {}, 
+                                                       .command_count = command_count, .spec = {}, .traits = {} };
 
-            if (!continue_on_error) {
-                // Stop processing on the first error
-                return false;
-            }
-        } else {
-            ret = true; // Add the valid flag
-        }
-    }
+      template <size_t P>
+      using declaration_type = std::tuple_element_t<P, std::tuple<DECLS...>>;
 
-    return ret; // Return true even if not all flags are valid 'cause we already advanced 
-                 // idk if we should only advance if all are valid? 
-}
+      // the tables of the command at schema index INDEX (and its subcommands' after it)
+      template <uint32_t INDEX>
+      struct tables
+      {
+        static constexpr auto shape = [] {
+          const auto table = declarations.table(INDEX);
+          return std::pair{ table.slots().size(), table.seeds().size() };
+        }();
 
+        struct hashed_symbols
+        {
+          std::array<detail::symbol, shape.first> slots{};
+          std::array<uint32_t, shape.second> seeds{};
+          uint64_t salt{ 0 };
+          size_t size{ 0 };
+        };
 
-      // returns argument_list as a space separated list if it can parse argument list 'till the end(with the closing)
-      // returns "" otherwise and it requires the token to be advanced externally
-      std::string parse_arguments_list(utf8::code_point expect_end, utf8::code_point sep)
-      {
-        // TODO: skip last whitespace(if any) and last comma (if any) 
-        // makes the user life way more easy if they want to auto generate the args list 
-        // like c++ it's valid to do so:
-        // auto x = { 1, 2, 3 , };
-        // currently supporting only comma separated lists e.g. [ arg1, arg2, arg3 ]
-        //TODO: add support for non comma separated lists e.g.  [ arg1 arg2 arg3 ] 
-        //TODO: check me
-        // we are now at the first argument 
-        std::stringstream ss;
+        static constexpr hashed_symbols symbols = [] {
+          const auto table = declarations.table(INDEX);
+          hashed_symbols out;
+          std::ranges::copy(table.slots(), out.slots.begin());
+          std::ranges::copy(table.seeds(), out.seeds.begin());
+          out.salt = table.salt();
+          out.size = table.size();
+          return out;
+        }();
+
+        static constexpr auto options = declarations.template gather<declarations.count(static_kind::option)>(static_kind::option, 
+          [](const static_declaration& decl) { return decl.spec; });
+        static constexpr auto flags = declarations.template gather<declarations.count(static_kind::flag)>(static_kind::flag, 
+          [](const static_declaration& decl) { return decl.name; });
+        static constexpr auto subcommands = [] {
+          std::array<uint32_t, declarations.count(static_kind::command)> out{};
+          for(size_t i = 0; i < out.size(); i++)
+            out[i] = INDEX + 1 + declarations.commands_before(declarations.position(static_kind::command, i));
+          return out;
+        }();
+        static constexpr static_traits value = declarations.value();
+
+        static constexpr static_command_spec spec{ NAME.view(), value.requires_value, value.allows_multiple, options, flags, subcommands, 
+                                                   symbols.slots, symbols.seeds, symbols.salt, symbols.size };
+
+        static constexpr void collect(std::span<static_command_spec> out)
+        {
+          out[INDEX] = spec;
+          collect(out, std::make_index_sequence<subcommands.size()>{});
+        }
 
-        // if the peek token is single Unicode char and it's equal to sep then it's valid 
-        while(utf8::is_single_char(m_peek_token.literal) && m_peek_token.literal[0] == sep)
+        template <size_t... C>
+        static constexpr void collect([[maybe_unused]] std::span<static_command_spec> out, std::index_sequence<C...>)
         {
-          ss << m_current_token.literal;
-          advance();
-          // we are now at the sep
-          advance();
-          // we are now at the next argument
+          (declaration_type<declarations.position(static_kind::command, C)>::template tables<subcommands[C]>::collect(out), ...);
         }
-        
-        if(!expect_next(expect_end)) // the state now is before the expected end i.e. at the last argument
-          return {};
+      };
+    };
 
-        // the state now is at the expect_end token
-        
-        // skip it 
-        advance();
-        return ss.str();
+    // every command of ROOT in schema order (the root first then the subcommands depth first)
+    template <typename ROOT>
+    inline constexpr auto static_commands = [] {
+      std::array<static_command_spec, ROOT::command_count> out{};
+      ROOT::template tables<0>::collect(out);
+      return out;
+    }();
+
+    // a command of a resault seen through its static_command, get<"name">() is the by handle get of the option,
+    // flag or subcommand (a view of it) with that name, which one and its handle are known at compile time
+    template <typename CMD>
+    class static_command_view
+    {
+    public:
+      explicit static_command_view(const command& cmd)
+        : m_command(&cmd)
+      {
       }
 
-      bool parse_value_s(std::string& val, bool allow_multiple, bool& r) 
+      template <fixed_name NAME>
+      auto get() const
       {
-        // we are now at the token after the identifire (might be assign or space) or both
+        constexpr auto found = CMD::declarations.find(NAME.view());
+        static_assert(found.matches != 0, "the static_command has nothing with this name");
+        static_assert(found.matches <= 1, "more than one thing of the static_command has this name, get it by handle");
 
-        // if its a space or assign skip it
-        if(m_current_token.type == detail::token_type::space)
-          advance(); //skip space TODO: or = (chnages the parser)
-        if(m_current_token.type == detail::token_type::assign) // require a value 
+        if constexpr(found.kind == static_kind::option)
         {
-          r = true; // syntax error
-          advance();
+          return m_command->get_option(option_handle{ found.index });
         }
-
-        // we are now at the value(s) token
-
-        if(allow_multiple)
+        else if constexpr(found.kind == static_kind::flag)
         {
-          const auto& args =  parse_args();
-          if(!args.empty())
-            val = args;
-          else 
-          {
-            // require advancment
-            return false;
-          }
+          return m_command->get_flag(flag_handle{ found.index });
         }
-        else 
+        else
         {
-          val = m_current_token.literal;
-          advance();
+          using view = static_command_view<typename CMD::template declaration_type<found.position>>;
+          const auto sub = m_command->get_command(command_handle{ found.index });
+          if(!sub)
+            return std::expected<view, command::state>{ std::unexpect, sub.error() };
+          return std::expected<view, command::state>{ view{ sub->get() } };
         }
-        return true;
       }
 
-      // checks if peek_token is equal to tt (token wise) if so it advances.
-      // returns true if so,
-      // false otherwise
-      bool expect_next(detail::token_type tt)
+      const command* operator->() const
       {
-        if(m_peek_token.type == tt)
-        {
-          advance();
-          return true;
-        }
-        return false;
+        return m_command;
       }
+    private:
+      const command* m_command;
+    };
 
-      bool peek_next(detail::token_type tt)
+    template <typename ROOT>
+    class static_resault : public parse_resault
+    {
+    public:
+      static_resault() = default;
+
+      explicit static_resault(parse_resault&& pr)
+        : parse_resault(std::move(pr))
       {
-        if(m_peek_token.type == tt)
-          return true;
-        return false;
       }
 
-      // checks if peek_token is equal to cp (unicode wise) if so it advances 
-      // returns true if so, 
-      // false otherwise
-      bool expect_next(utf8::code_point cp)
+      template <fixed_name NAME>
+      auto get() const
       {
-        //TODO: check me
-        size_t pos = 0;
-        if(utf8::decode(m_peek_token.literal, pos) == cp && pos >= m_peek_token.literal.size() - 1)
-        {
-          advance();
-          return true;
-        }
-        return false;
+        return static_command_view<ROOT>{ root }.template get<NAME>();
       }
+    };
 
-      // changes the m_current_resault_command->and the m_current_command to curr_cmd_res and curr_cmd_build
-      void change_command(command& curr_cmd_res, command_builder& curr_cmd_build)
+    // parses against a static_command, its schema only views the static specs and tables (no maps, 
+    // no interning, no hashing, no copies), the schema is shared by the sessions made from freeze()
+    template <typename ROOT>
+    class static_parser
+    {
+    public:
+      explicit static_parser(const detail::lexer_options& lexing = {})
+        : m_schema(std::make_shared<const schema>(std::span<const static_command_spec>{ static_commands<ROOT> }, lexing))
       {
-        m_current_resault_command = &curr_cmd_res;
-        m_current_command = &curr_cmd_build;
       }
 
-      // adds opt with the name 'name' to m_current_resault_command->m_options[name]
-      option& save_option(const std::string& name, const option& opt)
+      static_resault<ROOT> parse(int argc, char** argv) const
       {
-        m_current_resault_command->m_options[name] = opt;
-        return m_current_resault_command->m_options[name];
+        return static_resault<ROOT>{ parse_session{ m_schema, std::pmr::get_default_resource() }.parse(argc, argv) };
       }
 
-      // adds cmd with the name 'name' to m_current_resault_command->m_commands[name]
-      command& save_command(const std::string& name, const command& cmd)
+      // args must not contain the launch command name
+      static_resault<ROOT> parse(std::span<char* const> args) const
       {
-        m_current_resault_command->m_commands[name] = cmd;
-        return m_current_resault_command->m_commands[name];
+        return static_resault<ROOT>{ parse_session{ m_schema, std::pmr::get_default_resource() }.parse(args) };
       }
 
-      // adds f with the name 'name' to m_current_resault_command->m_flags[name]
-      flag& save_flag(const std::string& name, const flag& f)
+      static_resault<ROOT> parse(std::string_view line) const
       {
-        m_current_resault_command->m_flags[name] = f;
-        return m_current_resault_command->m_flags[name];
+        return static_resault<ROOT>{ parse_session{ m_schema, std::pmr::get_default_resource() }.parse(line) };
       }
 
-      // deprecated
-      //parse_resault build_base_resault()
-      //{
-        // just copy the skeleton of the builder(s)
-      //  parse_resault pr;
-        //pr.root = add_command(m_root);
-      //  return pr;
-      //}
-
-      //command add_command(const command_builder& cmd_build)
-      //{
-      //  command cmd;
-
-      //  for(const auto& subcmd_build : cmd_build.m_subcommands)
-      //  {
-      //    auto c = add_command(subcmd_build.second);
-      //    cmd.m_commands[subcmd_build.first] = {};
-      //  }
-
-      //  for(const auto& opt_build : cmd_build.m_options)
-      //  {
-      //    cmd.m_options[opt_build.first] = option{};
-      //  }
-
-      //  for(const auto& flag_name : cmd_build.m_flags)
-      //  {
-      //    cmd.m_flags[flag_name] = flag{};
-      //  }
-      //  return cmd;
-      //}
+      std::shared_ptr<const schema> freeze() const
+      {
+        return m_schema;
+      }
     private:
-      detail::lexer m_lx;
-      command_builder m_root; // root command (doesn't allow any value) update: why not?!
-                              // this would be the interface that builds the whole application
-      detail::token m_current_token,
-                    m_peek_token;
-      command_builder* m_current_command{ &m_root };
-
-      parse_resault m_resault;
-      command* m_current_resault_command{ &m_resault.root };
+      std::shared_ptr<const schema> m_schema;
     };
   }
 } //namespace clara::inline v_0_0_0
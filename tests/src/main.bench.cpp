@@ -0,0 +1,957 @@
+#include <clara/clara.hpp>
+
+#include <atomic>
+#include <cctype>
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <new>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+// every heap allocation goes through here so the benchmarks can report allocations per item,
+// they aren't inlined so gcc doesn't see a new expression paired with free() (-Wmismatched-new-delete)
+static std::atomic<size_t> g_allocations = 0;
+
+[[gnu::noinline]] void* operator new(size_t size)
+{
+  g_allocations.fetch_add(1, std::memory_order_relaxed);
+  if(void* p = std::malloc(size == 0 ? 1 : size))
+    return p;
+  throw std::bad_alloc{};
+}
+
+[[gnu::noinline]] void operator delete(void* p) noexcept
+{
+  std::free(p);
+}
+
+[[gnu::noinline]] void operator delete(void* p, size_t) noexcept
+{
+  std::free(p);
+}
+
+// std::pmr::new_delete_resource() uses the aligned versions
+[[gnu::noinline]] void* operator new(size_t size, std::align_val_t alignment)
+{
+  g_allocations.fetch_add(1, std::memory_order_relaxed);
+  const auto align = static_cast<size_t>(alignment);
+  if(void* p = std::aligned_alloc(align, (size + align - 1) / align * align))
+    return p;
+  throw std::bad_alloc{};
+}
+
+[[gnu::noinline]] void operator delete(void* p, std::align_val_t) noexcept
+{
+  std::free(p);
+}
+
+[[gnu::noinline]] void operator delete(void* p, size_t, std::align_val_t) noexcept
+{
+  std::free(p);
+}
+
+namespace bench
+{
+  using clock = std::chrono::steady_clock;
+
+  // runs fun 'runs' times and reports the best run
+  template <typename FUN>
+  void run(std::string_view name, size_t items, FUN&& fun, size_t runs = 5)
+  {
+    double best_ns = 0.0;
+    size_t best_allocs = 0;
+    for(size_t i = 0; i < runs; i++)
+    {
+      const auto allocs = g_allocations.load();
+      const auto start = clock::now();
+      fun();
+      const auto end = clock::now();
+      const double ns = std::chrono::duration<double, std::nano>(end - start).count();
+      if(i == 0 || ns < best_ns)
+      {
+        best_ns = ns;
+        best_allocs = g_allocations - allocs;
+      }
+    }
+    std::cout << name << ": " << best_ns / items << " ns/item, "
+              << static_cast<double>(best_allocs) / items << " allocs/item ("
+              << items << " items, " << best_ns / 1e6 << " ms)\n";
+  }
+
+  // keeps the compiler from dropping the work
+  template <typename T>
+  void keep(const T& value)
+  {
+    asm volatile("" : : "g"(&value) : "memory");
+  }
+
+  // argv made out of owned strings
+  struct args
+  {
+    std::vector<std::string> storage;
+    std::vector<char*> argv;
+
+    void finish()
+    {
+      argv.clear();
+      argv.push_back(const_cast<char*>("bench"));
+      for(auto& s : storage)
+        argv.push_back(s.data());
+      argv.push_back(nullptr);
+    }
+
+    int argc() const { return static_cast<int>(argv.size() - 1); }
+    std::span<char* const> words() const { return { argv.data() + 1, argv.size() - 2 }; }
+  };
+
+  // ~100k tokens of options with values that don't fit in a small string
+  std::string make_line(size_t options)
+  {
+    std::string line;
+    for(size_t i = 0; i < options; i++)
+      line += "--option_number_" + std::to_string(i % 64) + "=/some/rather/long/path/to/value_" + std::to_string(i) + " ";
+    return line;
+  }
+
+  args make_args(size_t options)
+  {
+    args a;
+    for(size_t i = 0; i < options; i++)
+    {
+      a.storage.push_back("--option_number_" + std::to_string(i % 64));
+      a.storage.push_back("/some/rather/long/path/to/value_" + std::to_string(i));
+    }
+    a.finish();
+    return a;
+  }
+
+  size_t count_tokens(clara::detail::lexer lx)
+  {
+    size_t n = 0;
+    for(auto tok = lx.advance(); tok.type != clara::detail::token_type::eof; tok = lx.advance())
+      n++;
+    return n;
+  }
+
+  void tokens()
+  {
+    std::cout << "== tokens ==\n";
+    const auto line = make_line(20000); // 5 tokens per option
+    const auto tokens = count_tokens(clara::detail::lexer{ line });
+
+    run("lexer (views into the input)", tokens, [&] {
+      clara::detail::lexer lx{ line };
+      for(auto tok = lx.advance(); tok.type != clara::detail::token_type::eof; tok = lx.advance())
+        keep(tok);
+    });
+
+    // what every token used to cost: one owned literal plus the copy into the current token
+    run("lexer + owned literal copies (old token)", tokens, [&] {
+      clara::detail::lexer lx{ line };
+      for(auto tok = lx.advance(); tok.type != clara::detail::token_type::eof; tok = lx.advance())
+      {
+        std::string literal{ tok.literal };
+        std::string current = literal;
+        keep(current);
+      }
+    });
+
+    const auto a = make_args(25000); // 4 tokens per option
+    const auto arg_tokens = count_tokens(clara::detail::lexer{ a.words() });
+    run("argv lexer (views into argv)", arg_tokens, [&] {
+      clara::detail::lexer lx{ a.words() };
+      for(auto tok = lx.advance(); tok.type != clara::detail::token_type::eof; tok = lx.advance())
+        keep(tok);
+    });
+  }
+
+  // the old validator, byte by byte (and lax)
+  bool legacy_is_valid_utf8(std::string_view input)
+  {
+    size_t pos = 0;
+    while(pos < input.size())
+    {
+      const size_t bytes = clara::utf8::detail::get_sequence_length(static_cast<uint8_t>(input[pos]));
+      if(bytes == 0 || pos + bytes > input.size() || !clara::utf8::detail::validate_continuation(input, pos, bytes))
+        return false;
+      pos += bytes;
+    }
+    return true;
+  }
+
+  void utf8()
+  {
+    std::cout << "== utf8 ==\n";
+    // a response file sized input, mostly ascii with some multi byte text in it
+    std::string input;
+    while(input.size() < (1 << 22))
+      input += "--path=/some/rather/long/path --name=\"caf\xc3\xa9 \xe2\x82\xac \xf0\x9f\x98\x80\" ";
+
+    namespace d = clara::utf8::detail;
+    run("legacy byte by byte validation", input.size(), [&] { keep(legacy_is_valid_utf8(input)); });
+    run("scalar validation", input.size(), [&] { keep(d::is_valid_utf8_scalar(input)); });
+#if defined(CLARA_X86_SIMD)
+    if(__builtin_cpu_supports("sse4.2"))
+      run("sse4.2 validation", input.size(), [&] { keep(d::is_valid_utf8_sse42(input)); });
+    if(__builtin_cpu_supports("avx2"))
+      run("avx2 validation", input.size(), [&] { keep(d::is_valid_utf8_avx2(input)); });
+#endif
+
+    // one long quoted value, the lexer used to validate each of its chars
+    const std::string quoted = "--value \"" + std::string(1 << 20, 'v') + "\"";
+    run("lexer long quoted value", quoted.size(), [&] { keep(count_tokens(clara::detail::lexer{ quoted })); });
+  }
+
+  // stage 1 on its own and the lexer over a long command line and over response file content
+  void scan()
+  {
+    std::cout << "== scan ==\n";
+    using scanner = clara::detail::structural_scanner;
+    const auto line = make_line(20000);
+    const auto classify = [&](scanner::classify_fn fn) {
+      return [&line, fn] {
+        for(size_t b = 0; b + 64 <= line.size(); b += 64)
+          keep(fn(line.data() + b));
+      };
+    };
+    run("scalar classify (per byte)", line.size(), classify(scanner::classify_scalar));
+#if defined(CLARA_X86_SIMD)
+    if(__builtin_cpu_supports("sse4.2"))
+      run("sse4.2 classify (per byte)", line.size(), classify(scanner::classify_sse42));
+    if(__builtin_cpu_supports("avx2"))
+      run("avx2 classify (per byte)", line.size(), classify(scanner::classify_avx2));
+#endif
+    run("lexer long command line (per byte)", line.size(), [&] { keep(count_tokens(clara::detail::lexer{ line })); });
+
+    // what a response file looks like: one option per line, quoted values with spaces and escapes
+    std::string file;
+    for(size_t i = 0; file.size() < (1 << 22); i++)
+      file += "--define=\"NAME_" + std::to_string(i) + "=some \\\"quoted\\\" value\"\n    --include '/usr/local/include/pkg_" 
+              + std::to_string(i % 100) + "'\n";
+    const auto mb = [&](std::string_view name, const std::string& input) {
+      const auto start = clock::now();
+      constexpr size_t reps = 5;
+      for(size_t i = 0; i < reps; i++)
+        keep(count_tokens(clara::detail::lexer{ input }));
+      const double s = std::chrono::duration<double>(clock::now() - start).count();
+      std::cout << name << ": " << reps * input.size() / s / 1e6 << " MB/s\n";
+    };
+    mb("lexer long command line", line);
+    mb("lexer response file", file);
+  }
+
+  // the per char work of the old lexer: a decode of the char and two of the next one (consume_whitespace
+  // peeked twice), isspace on the low byte and a delimiter set search
+  size_t legacy_char_walk(std::string_view input, const clara::detail::lexer::delimiter_set& ds)
+  {
+    size_t n = 0;
+    for(size_t pos = 0; pos < input.size();)
+    {
+      const size_t start = pos;
+      const auto cp = clara::utf8::decode(input, pos);
+      size_t peek = pos;
+      const auto next = clara::utf8::decode(input, peek);
+      peek = pos;
+      n += std::isspace(cp & 0xff) && std::isspace(clara::utf8::decode(input, peek) & 0xff) && next != 0;
+      n += ds.find(input.substr(start, pos - start)) != ds.end();
+    }
+    return n;
+  }
+
+  // the same with one decode per char (ascii without one) and the class table
+  size_t table_char_walk(std::string_view input, const clara::detail::char_classes& classes)
+  {
+    size_t n = 0;
+    for(size_t pos = 0; pos < input.size();)
+    {
+      const auto byte = static_cast<uint8_t>(input[pos]);
+      const auto cp = byte < 0x80 ? (pos++, byte) : clara::utf8::decode(input, pos);
+      n += classes.is(cp, clara::detail::char_classes::space);
+      n += classes.is(cp, clara::detail::char_classes::delimiter);
+    }
+    return n;
+  }
+
+  void chars()
+  {
+    std::cout << "== chars ==\n";
+    const auto ascii = make_line(20000);
+    std::string mixed; // the same shape with 2, 3 and 4 byte chars in every token
+    for(size_t i = 0; mixed.size() < ascii.size(); i++)
+      mixed += "--op\xc3\xa7\xc3\xa3o_" + std::to_string(i % 64) + "=/caf\xc3\xa9/\xe2\x82\xac/\xf0\x9f\x98\x80_" + std::to_string(i) + " ";
+
+    const clara::detail::lexer::delimiter_set ds{ CLARA_DELIMITER };
+    const clara::detail::char_classes classes{ ds };
+    for(const auto& [name, input] : { std::pair<std::string, std::string_view>{ "ascii", ascii }, { "mixed", mixed } })
+    {
+      run(name + " old char walk (per byte)", input.size(), [&] { keep(legacy_char_walk(input, ds)); });
+      run(name + " class table walk (per byte)", input.size(), [&] { keep(table_char_walk(input, classes)); });
+      const auto tokens = count_tokens(clara::detail::lexer{ input });
+      run(name + " lexer", tokens, [&] { keep(count_tokens(clara::detail::lexer{ input })); });
+    }
+  }
+
+  // what parse::get used to do: a std::string, sto* and an exception for bad input
+  std::pair<int64_t, bool> legacy_get_int(const std::string& value)
+  {
+    try {
+      return { std::stol(value), true };
+    } catch(...) {
+      return { 0, false };
+    }
+  }
+
+  std::pair<double, bool> legacy_get_double(const std::string& value)
+  {
+    try {
+      return { std::stod(value), true };
+    } catch(...) {
+      return { 0.0, false };
+    }
+  }
+
+  void convert()
+  {
+    std::cout << "== convert ==\n";
+    std::vector<std::string> ints, doubles, bad;
+    for(size_t i = 0; i < 100000; i++)
+    {
+      ints.push_back(std::to_string(i * 7919));
+      doubles.push_back(std::to_string(i * 0.37) + "e-2");
+      bad.push_back("not_a_number_" + std::to_string(i));
+    }
+    const auto each = [](const std::vector<std::string>& values, auto fun) {
+      return [&values, fun] {
+        for(const auto& v : values)
+          keep(fun(v));
+      };
+    };
+    run("stol + try/catch (int64)", ints.size(), each(ints, legacy_get_int));
+    run("from_chars (int64)", ints.size(), each(ints, [](std::string_view v) { return clara::parse::get<int64_t>(v); }));
+    run("stod + try/catch (double)", doubles.size(), each(doubles, legacy_get_double));
+    run("from_chars (double)", doubles.size(), each(doubles, [](std::string_view v) { return clara::parse::get<double>(v); }));
+    run("stol + try/catch (malformed)", bad.size(), each(bad, legacy_get_int));
+    run("from_chars (malformed)", bad.size(), each(bad, [](std::string_view v) { return clara::parse::get<int64_t>(v); }));
+  }
+
+  // what resolving '--name' costs: the old alias map then option map search vs one probe
+  void lookup()
+  {
+    std::cout << "== lookup ==\n";
+    std::vector<std::string> names;
+    for(size_t i = 0; i < 64; i++)
+      names.push_back("option_number_" + std::to_string(i));
+
+    clara::detail::string_map<std::string> aliases;
+    clara::detail::string_map<int> options;
+    std::vector<clara::detail::symbol> symbols;
+    for(uint32_t i = 0; i < names.size(); i++)
+    {
+      options[names[i]] = static_cast<int>(i);
+      symbols.push_back({ names[i], clara::detail::symbol::option, i });
+    }
+    for(uint32_t i = 0; i < 16; i++)
+    {
+      const auto alias = "o" + std::to_string(i);
+      aliases[alias] = names[i];
+      symbols.push_back({ {}, clara::detail::symbol::alias, 0, i });
+    }
+    std::vector<std::string> alias_names;
+    for(const auto& [alias, _] : aliases)
+      alias_names.push_back(alias);
+    for(size_t i = 0; i < 16; i++)
+      symbols[names.size() + i].name = alias_names[i];
+    clara::detail::symbol_table table{ symbols };
+
+    // views into one buffer like the lexer's tokens
+    const auto line = make_line(20000);
+    std::vector<std::string_view> queries;
+    for(size_t pos = line.find("--"); pos != std::string::npos; pos = line.find("--", pos + 2))
+      queries.push_back(std::string_view{ line }.substr(pos + 2, line.find('=', pos) - pos - 2));
+
+    run("string_map alias + option find", queries.size(), [&] {
+      for(const auto q : queries)
+      {
+        if(aliases.find(q) == aliases.end())
+          keep(options.find(q));
+      }
+    });
+
+    run("symbol_table::find", queries.size(), [&] {
+      for(const auto q : queries)
+        keep(table.find(q));
+    });
+
+    // a '-xzvf' cluster: a symbol lookup per char vs the command's flag bitmap
+    static constexpr std::string_view letters = "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ";
+    std::vector<std::string_view> flag_names;
+    std::vector<clara::detail::symbol> flag_symbols;
+    for(uint32_t i = 0; i < letters.size(); i++)
+    {
+      flag_names.push_back(letters.substr(i, 1));
+      flag_symbols.push_back({ flag_names.back(), clara::detail::symbol::flag, 0, 0, 0, i });
+    }
+    clara::detail::symbol_table flag_table{ flag_symbols };
+    clara::detail::flag_chars flag_chars{ flag_names };
+    std::vector<std::string> clusters;
+    for(size_t i = 0; i < 20000; i++)
+      clusters.push_back(std::string{ letters.substr(i % 40, 4 + i % 8) });
+
+    run("symbol_table::find per cluster char", clusters.size(), [&] {
+      for(const auto& c : clusters)
+      {
+        bool all = true;
+        for(size_t i = 0; i < c.size() && all; i++)
+          all = flag_table.find(std::string_view{ c }.substr(i, 1)) != nullptr;
+        for(size_t i = 0; all && i < c.size(); i++)
+          keep(flag_table.find(std::string_view{ c }.substr(i, 1))->flag_index);
+      }
+    });
+
+    run("flag_chars::all + each", clusters.size(), [&] {
+      for(const auto& c : clusters)
+      {
+        if(flag_chars.all(c))
+          flag_chars.each(c, [](uint32_t handle) { keep(handle); });
+      }
+    });
+  }
+
+  void parse()
+  {
+    std::cout << "== parse ==\n";
+    auto a = make_args(25000);
+    clara::parse::parser p;
+    for(size_t i = 0; i < 64; i++)
+      p.add_option("option_number_" + std::to_string(i)).requires_value();
+
+    run("parse(argc, argv)", a.storage.size(), [&] {
+      auto pr = p.parse(a.argc(), a.argv.data());
+      keep(pr);
+    });
+
+    // the same walked once by a visitor, no resault is built
+    struct count : clara::parse::parse_visitor
+    {
+      size_t bytes{ 0 };
+      void on_option(clara::parse::option_handle, std::string_view, std::string_view value, std::span<const uint32_t>) override
+      {
+        bytes += value.size();
+      }
+    } visitor;
+    clara::parse::parse_session visit_session{ p };
+    const std::span<char* const> args{ a.argv.data() + 1, static_cast<size_t>(a.argc() - 1) };
+    run("session.parse(args) + walk", a.storage.size(), [&] {
+      {
+        auto pr = visit_session.parse(args);
+        size_t bytes = 0;
+        for(const auto& [name, o] : pr.root.get_options())
+          bytes += o.get_raw().size();
+        keep(bytes);
+      }
+      visit_session.reset();
+    });
+    // lexed into a token array first, then parsed from it
+    p.token_array();
+    clara::parse::parse_session array_session{ p };
+    run("session.parse(args) (token_array)", a.storage.size(), [&] {
+      keep(array_session.parse(args));
+      array_session.reset();
+    });
+    p.token_array(false);
+
+    run("session.visit(args)", a.storage.size(), [&] {
+      visit_session.visit(args, visitor);
+      keep(visitor.bytes);
+      visit_session.reset();
+    });
+
+    // many small command lines against one schema
+    auto small = make_args(4);
+    constexpr size_t lines = 20000;
+    run("parser::parse (small lines)", lines, [&] {
+      for(size_t i = 0; i < lines; i++)
+      {
+        auto pr = p.parse(small.argc(), small.argv.data());
+        keep(pr);
+      }
+    });
+
+    // the same option asked for over and over, converted on each get vs loaded
+    p.add_option("raw_jobs").requires_value();
+    p.add_option("typed_jobs").as<int64_t>();
+    auto jobs = make_args(0);
+    jobs.storage = { "--raw_jobs", "123456", "--typed_jobs", "123456" };
+    jobs.finish();
+    const auto jobs_pr = p.parse(jobs.argc(), jobs.argv.data());
+    const auto& raw_jobs = jobs_pr.root.get_option("raw_jobs")->get();
+    const auto& typed_jobs = jobs_pr.root.get_option("typed_jobs")->get();
+    constexpr size_t gets = 1000000;
+    run("option::get<int64_t> (raw)", gets, [&] {
+      for(size_t i = 0; i < gets; i++)
+        keep(raw_jobs.get<int64_t>());
+    });
+    run("option::get<int64_t> (.as<int64_t>())", gets, [&] {
+      for(size_t i = 0; i < gets; i++)
+        keep(typed_jobs.get<int64_t>());
+    });
+
+    const clara::parse::option_handle typed_handle = p.add_option("typed_jobs");
+    run("command::get_option by name", gets, [&] {
+      for(size_t i = 0; i < gets; i++)
+        keep(jobs_pr.root.get_option("typed_jobs"));
+    });
+    run("command::get_option by handle", gets, [&] {
+      for(size_t i = 0; i < gets; i++)
+        keep(jobs_pr.root.get_option(typed_handle));
+    });
+
+    // a service's startup: parse then look every option up vs parse straight into the config
+    struct config
+    {
+      int64_t threads{ 0 };
+      std::string out;
+      double ratio{ 0.0 };
+    };
+    clara::parse::parser lookup_p, bind_p;
+    lookup_p.add_option("threads").as<int64_t>();
+    lookup_p.add_option("out").as<std::string>();
+    lookup_p.add_option("ratio").as<double>();
+    bind_p.add_option("threads").bind(&config::threads);
+    bind_p.add_option("out").bind(&config::out);
+    bind_p.add_option("ratio").bind(&config::ratio);
+    auto startup = make_args(0);
+    startup.storage = { "--threads", "16", "--out", "/var/log/service.log", "--ratio", "0.75" };
+    startup.finish();
+    config cfg;
+    run("parse + get_option chain (startup)", lines, [&] {
+      for(size_t i = 0; i < lines; i++)
+      {
+        auto pr = lookup_p.parse(startup.argc(), startup.argv.data());
+        cfg.threads = pr.root.get_option("threads")->get().get<int64_t>().value_or(0);
+        cfg.out = pr.root.get_option("out")->get().get<std::string>().value_or("");
+        cfg.ratio = pr.root.get_option("ratio")->get().get<double>().value_or(0.0);
+        keep(cfg);
+      }
+    });
+    run("parse_into bound config (startup)", lines, [&] {
+      for(size_t i = 0; i < lines; i++)
+      {
+        auto pr = bind_p.parse_into(cfg, startup.argc(), startup.argv.data());
+        keep(cfg);
+      }
+    });
+
+    clara::parse::parse_session session{ p };
+    run("parse_session::parse + reset (small lines)", lines, [&] {
+      for(size_t i = 0; i < lines; i++)
+      {
+        {
+          auto pr = session.parse(small.argc(), small.argv.data());
+          keep(pr);
+        }
+        session.reset();
+      }
+    });
+  }
+
+  // one schema, one session per thread, every thread parses the same number of lines
+  // a 100k value list read back: the old split of the joined raw string vs the stored ends
+  void values()
+  {
+    std::cout << "== values ==\n";
+    clara::parse::parser p;
+    p.add_option("files").allow_multiple().requires_value();
+    auto a = make_args(0);
+    a.storage.push_back("--files");
+    for(size_t i = 0; i < 100000; i++)
+      a.storage.push_back("/some/path/" + std::to_string(i));
+    a.finish();
+
+    const size_t count = a.storage.size() - 1;
+    run("parse 100k value list", count, [&] {
+      auto pr = p.parse(a.argc(), a.argv.data());
+      keep(pr);
+    });
+
+    const auto pr = p.parse(a.argc(), a.argv.data());
+    const auto& files = pr.root.get_option("files")->get();
+    run("split get_raw() on spaces", count, [&] {
+      std::stringstream ss{ std::string{ files.get_raw() } };
+      std::vector<std::string> vec;
+      std::string item;
+      while(ss >> item)
+        vec.push_back(item);
+      keep(vec);
+    });
+
+    run("values()", count, [&] {
+      size_t bytes = 0;
+      for(const auto v : files.values())
+        bytes += v.size();
+      keep(bytes);
+    });
+  }
+
+  // 1M element --ids/--weights lists: one std::stol/stod per split value vs the bulk conversion, 
+  // and what each kernel alone costs to split them
+  void lists()
+  {
+    std::cout << "== lists ==\n";
+    constexpr size_t count = 1000000;
+    clara::parse::parser p;
+    p.add_option("ids").allow_multiple().requires_value();
+    p.add_option("weights").allow_multiple().requires_value();
+    auto a = make_args(0);
+    a.storage.push_back("--ids");
+    for(size_t i = 0; i < count; i++)
+      a.storage.push_back(std::to_string(i * 2654435761u % 100000000000u));
+    a.storage.push_back("--weights");
+    for(size_t i = 0; i < count; i++)
+      a.storage.push_back("0." + std::to_string(i * 2654435761u % 1000000u));
+    a.finish();
+    const auto pr = p.parse(a.argc(), a.argv.data());
+    const auto& ids = pr.root.get_option("ids")->get();
+    const auto& weights = pr.root.get_option("weights")->get();
+
+    std::vector<int64_t> int_out(count);
+    std::vector<double> double_out(count);
+    run("stol per value (int64)", count, [&] {
+      size_t i = 0;
+      for(const auto v : ids.values())
+        int_out[i++] = legacy_get_int(std::string{ v }).first;
+      keep(int_out);
+    });
+    run("get_list (int64)", count, [&] {
+      keep(ids.get_list(std::span{ int_out }));
+    });
+    run("stod per value (double)", count, [&] {
+      size_t i = 0;
+      for(const auto v : weights.values())
+        double_out[i++] = legacy_get_double(std::string{ v }).first;
+      keep(double_out);
+    });
+    run("from_chars per value (double)", count, [&] {
+      size_t i = 0;
+      for(const auto v : weights.values_as<double>())
+        double_out[i++] = *v;
+      keep(double_out);
+    });
+    run("get_list (double)", count, [&] {
+      keep(weights.get_list(std::span{ double_out }));
+    });
+    run("get_list (int64, arena)", count, [&] {
+      keep(ids.get_list<int64_t>());
+    });
+
+    const size_t cores = std::max(1u, std::thread::hardware_concurrency());
+    for(const size_t n : { size_t{ 2 }, cores })
+    {
+      run("get_list (double, " + std::to_string(n) + " threads)", count, [&] {
+        keep(weights.get_list(std::span{ double_out }, n));
+      });
+      if(cores <= 2)
+        break;
+    }
+
+    using parser = clara::detail::decimal_parser;
+    std::vector<std::pair<std::string, parser::parse_fn>> kernels{ { "scalar", parser::parse_scalar } };
+#if defined(CLARA_X86_SIMD)
+    if(__builtin_cpu_supports("sse4.2"))
+      kernels.emplace_back("sse4.2", parser::parse_sse42);
+    if(__builtin_cpu_supports("avx2"))
+      kernels.emplace_back("avx2", parser::parse_avx2);
+#endif
+    const std::string_view raw = ids.get_raw();
+    std::vector<uint32_t> ends;
+    for(const auto v : ids.values())
+      ends.push_back(static_cast<uint32_t>(v.data() + v.size() - raw.data()));
+    std::vector<clara::detail::decimal> split(count);
+    for(const auto& [name, kernel] : kernels)
+    {
+      run("split ints " + name, count, [&] {
+        keep(kernel(raw, ends.data(), 0, count, split.data()));
+      });
+    }
+  }
+
+  // a 50k argument response file: read into a string, split and rebuilt as argv (what callers did) vs '@file'
+  void response()
+  {
+    std::cout << "== response files ==\n";
+    const auto path = std::filesystem::temp_directory_path() / "clara_bench.rsp";
+    const auto a = make_args(25000);
+    {
+      std::ofstream out{ path };
+      for(const auto& word : a.storage)
+        out << word << '\n';
+    }
+
+    clara::parse::parser p;
+    p.response_files();
+    for(size_t i = 0; i < 64; i++)
+      p.add_option("option_number_" + std::to_string(i)).requires_value();
+
+    run("read + split + parse(argc, argv)", a.storage.size(), [&] {
+      std::ifstream in{ path };
+      const std::string text{ std::istreambuf_iterator<char>{ in }, {} };
+      std::vector<std::string> words;
+      std::istringstream ss{ text };
+      for(std::string word; ss >> word;)
+        words.push_back(word);
+      std::vector<char*> argv{ const_cast<char*>("bench") };
+      for(auto& word : words)
+        argv.push_back(word.data());
+      keep(p.parse(static_cast<int>(argv.size()), argv.data()));
+    });
+
+    const std::string at = "@" + path.string();
+    char* argv[] = { const_cast<char*>("bench"), const_cast<char*>(at.c_str()) };
+    run("parse(argc, {@file})", a.storage.size(), [&] {
+      keep(p.parse(2, argv));
+    });
+    std::filesystem::remove(path);
+  }
+
+  // a line that comes in pipe sized chunks, lexed as it comes vs joined and then parsed
+  void stream()
+  {
+    std::cout << "== streamed lines ==\n";
+    const auto a = make_args(25000);
+    std::string line;
+    for(const auto& word : a.storage)
+      line += word + ' ';
+    clara::parse::parser p;
+    for(size_t i = 0; i < 64; i++)
+      p.add_option("option_number_" + std::to_string(i)).requires_value();
+    clara::parse::parse_session session{ p };
+
+    for(const size_t size : { 4096, 512 })
+    {
+      std::string joined;
+      run("join " + std::to_string(size) + "B chunks + parse(line)", a.storage.size(), [&] {
+        joined.clear();
+        for(size_t at = 0; at < line.size(); at += size)
+          joined.append(std::string_view{ line }.substr(at, size));
+        keep(session.parse(joined));
+        session.reset();
+      });
+      run("feed " + std::to_string(size) + "B chunks + finish()", a.storage.size(), [&] {
+        for(size_t at = 0; at < line.size(); at += size)
+          session.feed(std::string_view{ line }.substr(at, size));
+        keep(session.finish());
+        session.reset();
+      });
+    }
+  }
+
+  // a repl line split into words by an allocating splitter and parsed as argv, vs parsed with shell_words()
+  void shell()
+  {
+    std::cout << "== shell words ==\n";
+    std::string line;
+    for(size_t i = 0; i < 16; i++)
+      line += "--option_number_" + std::to_string(i) + (i % 2 == 0 ? "=\"quoted value " + std::to_string(i) + "\" " : " plain ");
+    clara::parse::parser p;
+    for(size_t i = 0; i < 16; i++)
+      p.add_option("option_number_" + std::to_string(i)).requires_value();
+    clara::parse::parse_session split_session{ p };
+    p.shell_words();
+    clara::parse::parse_session shell_session{ p };
+
+    constexpr size_t lines = 10000;
+    run("split into std::strings + parse(argv)", lines, [&] {
+      for(size_t n = 0; n < lines; n++)
+      {
+        std::vector<std::string> words(1);
+        bool quoted = false;
+        for(const char c : line)
+        {
+          if(c == '"')
+            quoted = !quoted;
+          else if(c == ' ' && !quoted)
+            words.emplace_back();
+          else
+            words.back() += c;
+        }
+        std::vector<char*> argv;
+        for(auto& word : words)
+          argv.push_back(word.data());
+        keep(split_session.parse(argv));
+        split_session.reset();
+      }
+    });
+    run("parse(line) with shell_words()", lines, [&] {
+      for(size_t n = 0; n < lines; n++)
+      {
+        keep(shell_session.parse(std::string_view{ line }));
+        shell_session.reset();
+      }
+    });
+  }
+
+  // a 64MB id list (a big response file) lexed on 1, 2, 4... threads up to the core count
+  void parallel_lex()
+  {
+    std::cout << "== parallel lexing ==\n";
+    std::string line;
+    line.reserve(64 << 20);
+    for(size_t i = 0; line.size() < (64 << 20); i++)
+      line += "--id " + std::to_string(i * 2654435761u % 100000000000u) + (i % 16 == 0 ? " --name \"test shard " + std::to_string(i) + "\" " : " ");
+
+    const size_t tokens = count_tokens(clara::detail::lexer{ line });
+    const size_t cores = std::max(1u, std::thread::hardware_concurrency());
+    for(size_t n = 1; n <= std::max<size_t>(2, cores); n *= 2)
+    {
+      const clara::detail::lexer_options opts{ .threads = n, .parallel_min_bytes = 1 };
+      run("lex 64MB, " + std::to_string(n) + " thread(s)", tokens, [&] {
+        keep(count_tokens(clara::detail::lexer{ line, clara::detail::lexer::default_delimiters(), opts }));
+      }, 3);
+    }
+  }
+
+  void threads()
+  {
+    std::cout << "== threads ==\n";
+    clara::parse::parser p;
+    for(size_t i = 0; i < 64; i++)
+      p.add_option("option_number_" + std::to_string(i)).requires_value();
+    const auto sc = p.freeze();
+    auto small = make_args(4);
+    constexpr size_t lines = 20000;
+
+    double single = 0.0;
+    const size_t cores = std::max(1u, std::thread::hardware_concurrency());
+    std::vector<size_t> counts;
+    for(size_t n = 1; n < cores; n *= 2)
+      counts.push_back(n);
+    counts.push_back(cores); // the last step is all the cores
+
+    for(const auto n : counts)
+    {
+      const auto start = clock::now();
+      std::vector<std::thread> workers;
+      for(size_t t = 0; t < n; t++)
+      {
+        workers.emplace_back([&] {
+          clara::parse::parse_session session{ sc };
+          for(size_t i = 0; i < lines; i++)
+          {
+            {
+              auto pr = session.parse(small.argc(), small.argv.data());
+              keep(pr);
+            }
+            session.reset();
+          }
+        });
+      }
+      for(auto& w : workers)
+        w.join();
+      const double s = std::chrono::duration<double>(clock::now() - start).count();
+      const double rate = n * lines / s;
+      if(n == 1)
+        single = rate;
+      std::cout << n << " thread(s): " << rate << " lines/s (" << rate / single << "x)\n";
+    }
+  }
+
+  // a replayed command log, one line per invocation
+  void batch()
+  {
+    std::cout << "== batch ==\n";
+    clara::parse::parser p;
+    p.add_flag("v");
+    for(size_t i = 0; i < 64; i++)
+      p.add_option("option_number_" + std::to_string(i)).requires_value();
+    const auto sc = p.freeze();
+
+    std::vector<std::string> storage;
+    for(size_t i = 0; i < 200000; i++)
+      storage.push_back("-v --option_number_" + std::to_string(i % 64) + " /some/path/" + std::to_string(i) 
+                        + (i % 100 == 0 ? " --unknown" : ""));
+    std::vector<std::string_view> lines(storage.begin(), storage.end());
+
+    const size_t cores = std::max(1u, std::thread::hardware_concurrency());
+    for(const size_t n : { size_t{ 1 }, cores })
+    {
+      const auto br = clara::parse::parse_many(sc, lines, n);
+      std::cout << "parse_many " << n << " thread(s): " << br.lines_per_second() << " lines/s, " 
+                << br.error_count() << " lines with errors (" << br.size() << " lines, " << br.seconds() * 1e3 << " ms)\n";
+      if(cores == 1)
+        break;
+    }
+  }
+
+  // "option_number_<I>" as a template argument
+  template <size_t I>
+  constexpr auto option_name()
+  {
+    constexpr std::string_view prefix = "option_number_";
+    constexpr size_t digits = I < 10 ? 1 : I < 100 ? 2 : 3;
+    clara::parse::fixed_name<prefix.size() + digits + 1> name;
+    std::ranges::copy(prefix, name.chars);
+    for(size_t i = 0, v = I; i < digits; i++, v /= 10)
+      name.chars[prefix.size() + digits - 1 - i] = static_cast<char>('0' + v % 10);
+    return name;
+  }
+
+  template <size_t... I>
+  auto static_options(std::index_sequence<I...>) -> clara::parse::static_command<"tool", clara::parse::static_flag<"v">,
+    clara::parse::static_option<option_name<I>(), void, { .requires_value = true }>...>;
+
+  // what a schema costs before the first parse: add_* calls and freeze() vs copying the compile time tables
+  void startup()
+  {
+    std::cout << "== startup ==\n";
+    constexpr size_t options = 512;
+    using cli = decltype(static_options(std::make_index_sequence<options>{}));
+    std::vector<std::string> names;
+    for(size_t i = 0; i < options; i++)
+      names.push_back("option_number_" + std::to_string(i));
+
+    run("parser add_* + freeze (512 options)", options, [&] {
+      clara::parse::parser p;
+      p.add_flag("v");
+      for(const auto& name : names)
+        p.add_option(name).requires_value();
+      keep(p.freeze());
+    });
+
+    run("static_parser (512 options)", options, [&] {
+      clara::parse::static_parser<cli> p;
+      keep(p.freeze());
+    });
+
+    args a;
+    a.storage = { "-v", "--option_number_511", "x" };
+    a.finish();
+    const clara::parse::static_parser<cli> p;
+    const auto pr = p.parse(a.words());
+    std::cout << "get<\"option_number_511\">: " << pr.get<"option_number_511">()->get().get_raw() << "\n";
+  }
+} // namespace bench
+
+int main()
+{
+  bench::tokens();
+  bench::utf8();
+  bench::scan();
+  bench::chars();
+  bench::convert();
+  bench::lookup();
+  bench::parse();
+  bench::values();
+  bench::lists();
+  bench::response();
+  bench::stream();
+  bench::shell();
+  bench::parallel_lex();
+  bench::threads();
+  bench::batch();
+  bench::startup();
+}
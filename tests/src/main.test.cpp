@@ -1,7 +1,7 @@
 #include <clara/clara.hpp>
 #include <iostream>
 
-void print_cmd(const std::string&, const clara::parse::command& cmd);
+void print_cmd(std::string_view, const clara::parse::command& cmd);
 void test_lexer(int argc, char** argv);
 void test_parser(int argc, char** argv);
 
@@ -24,8 +24,7 @@ int main(int argc, char** argv)
 
 void test_lexer(int argc, char** argv)
 {
-  auto args_str = clara::detail::join_args(argc, argv);
-  clara::detail::lexer lx(args_str);
+  clara::detail::lexer lx(std::span<char* const>(argv + 1, argc - 1));
 
   auto tok = lx.advance();
   std::cout << "first token: type: " << clara::detail::token_type_to_string(tok.type) << " literal: " << tok.literal << "\n";
@@ -55,7 +54,7 @@ void test_parser(int argc, char** argv)
   print_cmd("root", pr.root);
 }
 
-void print_cmd(const std::string& n, const clara::parse::command& cmd)
+void print_cmd(std::string_view n, const clara::parse::command& cmd)
 {
   std::cout << "cmd: [" << n << " raw data: " << cmd.get_raw() << "\n";
   for(const auto& scmd : cmd.get_subcommands())